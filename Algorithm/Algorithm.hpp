@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <utility>
+
 namespace kstd {
     template<class InputIt, class T>
     InputIt find(InputIt first, InputIt last, const T &value) {
@@ -56,4 +59,147 @@ namespace kstd {
         }
         return out;
     }
-}
\ No newline at end of file
+
+    template<class ForwardIt, class Compare>
+    bool isSorted(ForwardIt first, ForwardIt last, Compare less) {
+        if (first == last) {
+            return true;
+        }
+        for (ForwardIt next = first; ++next != last; first = next) {
+            if (less(*next, *first)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class ForwardIt>
+    bool isSorted(ForwardIt first, ForwardIt last) {
+        return kstd::isSorted(first, last, [](const auto &lhs, const auto &rhs) { return lhs < rhs; });
+    }
+
+    // keeps the first of every run of equal elements and returns the new end
+    template<class ForwardIt>
+    ForwardIt unique(ForwardIt first, ForwardIt last) {
+        if (first == last) {
+            return last;
+        }
+        ForwardIt result = first;
+        while (++first != last) {
+            if (!(*result == *first) && ++result != first) {
+                *result = std::move(*first);
+            }
+        }
+        return ++result;
+    }
+
+    template<class RandomIt, class Compare>
+    void insertionSort(RandomIt first, RandomIt last, Compare less) {
+        if (first == last) {
+            return;
+        }
+        for (RandomIt it = first + 1; it != last; ++it) {
+            auto value = std::move(*it);
+            RandomIt hole = it;
+            for (; hole != first && less(value, *(hole - 1)); --hole) {
+                *hole = std::move(*(hole - 1));
+            }
+            *hole = std::move(value);
+        }
+    }
+
+    template<class RandomIt, class Compare>
+    void heapSort(RandomIt first, RandomIt last, Compare less) {
+        size_t n = last - first;
+        auto siftDown = [&](size_t idx, size_t size) {
+            auto value = std::move(first[idx]);
+            for (size_t child = 2 * idx + 1; child < size; child = 2 * idx + 1) {
+                if (child + 1 < size && less(first[child], first[child + 1])) {
+                    ++child;
+                }
+                if (!less(value, first[child])) {
+                    break;
+                }
+                first[idx] = std::move(first[child]);
+                idx = child;
+            }
+            first[idx] = std::move(value);
+        };
+
+        for (size_t idx = n / 2; idx-- > 0;) {
+            siftDown(idx, n);
+        }
+        for (size_t size = n; size > 1; --size) {
+            kstd::swap(first[0], first[size - 1]);
+            siftDown(0, size - 1);
+        }
+    }
+
+    /*
+     * introsort: quicksort with a median of three pivot,
+     * heap sort once the recursion gets too deep
+     * and insertion sort for short ranges
+     */
+    template<class RandomIt, class Compare>
+    void sort(RandomIt first, RandomIt last, Compare less) {
+        const ptrdiff_t SHORT = 16;
+
+        size_t depth = 0;
+        for (size_t n = last - first; n > 1; n >>= 1) {
+            depth += 2;
+        }
+
+        while (last - first > SHORT) {
+            if (depth-- == 0) {
+                kstd::heapSort(first, last, less);
+                return;
+            }
+
+            RandomIt mid = first + (last - first) / 2;
+            if (less(*mid, *first)) {
+                kstd::swap(*mid, *first);
+            }
+            if (less(*(last - 1), *mid)) {
+                kstd::swap(*(last - 1), *mid);
+                if (less(*mid, *first)) {
+                    kstd::swap(*mid, *first);
+                }
+            }
+            kstd::swap(*first, *mid);
+
+            // equal elements stop both scans, so runs of them are split evenly
+            RandomIt i = first + 1;
+            RandomIt j = last - 1;
+            while (true) {
+                while (i <= j && less(*i, *first)) {
+                    ++i;
+                }
+                while (i <= j && less(*first, *j)) {
+                    --j;
+                }
+                if (i >= j) {
+                    break;
+                }
+                kstd::swap(*i, *j);
+                ++i;
+                --j;
+            }
+            kstd::swap(*first, *j);
+
+            // recurse into the shorter side, loop on the longer one
+            if (j - first < last - (j + 1)) {
+                kstd::sort(first, j, less);
+                first = j + 1;
+            } else {
+                kstd::sort(j + 1, last, less);
+                last = j;
+            }
+        }
+        kstd::insertionSort(first, last, less);
+    }
+
+    template<class RandomIt>
+    void sort(RandomIt first, RandomIt last) {
+        kstd::sort(first, last, [](const auto &lhs, const auto &rhs) { return lhs < rhs; });
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iterator>
+#include "../TypeTraits/TypeTraits.hpp"
 
 template<class T>
 class ArrayIterator {
@@ -42,6 +43,11 @@ public:
     pointer base() const;
 };
 
+namespace kstd {
+    template<class T>
+    struct is_contiguous_iterator<ArrayIterator<T>> : std::true_type {};
+}
+
 template<class T>
 ArrayIterator<T>::ArrayIterator(ArrayIterator::pointer i) : i(i) {}
 
@@ -0,0 +1,969 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "../Algorithm/Algorithm.hpp"
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../Pair/Pair.hpp"
+#include "../Vector/Vector.hpp"
+
+/*
+ * OrderedSet as a B+ tree
+ *
+ * the elements are kept sorted in the leaves, the inner nodes only hold
+ * separators, separator i is the smallest element of child i + 1 at the time it was set,
+ * so everything left of it is smaller and everything right of it is not
+ *
+ * a node takes about NodeSize bytes, so a search touches one node per level
+ * and scans a short sorted array in it, add / remove / find are O(log n)
+ * the leaves are linked both ways, iterating is a walk over them
+ *
+ * add splits full nodes and remove refills nodes at the minimum on the way down,
+ * so neither has to walk back up
+ *
+ * every inner node also keeps the number of elements under each child,
+ * which makes rank and select O(log n) as well
+ *
+ * elements are compared with < only, two elements are equal when neither is smaller
+ */
+template<class T, size_t NodeSize = 256>
+class BTreeSet {
+private:
+    struct Node {
+        bool leaf;
+        unsigned count;
+    };
+
+    static constexpr size_t atLeast4(size_t n) {
+        return n < 4 ? 4 : n;
+    }
+
+public:
+    static constexpr size_t LEAF_CAPACITY = atLeast4((NodeSize - sizeof(Node) - 2 * sizeof(void *)) / sizeof(T));
+    static constexpr size_t INNER_CAPACITY = atLeast4((NodeSize - sizeof(Node) - sizeof(void *) - sizeof(size_t)) /
+                                                      (sizeof(T) + sizeof(void *) + sizeof(size_t)));
+
+private:
+    static constexpr size_t LEAF_MIN = LEAF_CAPACITY / 2;
+    static constexpr size_t INNER_MIN = (INNER_CAPACITY - 1) / 2;
+    // every inner node has at least two children, so no path is longer than this
+    static constexpr size_t MAX_DEPTH = 8 * sizeof(size_t);
+
+    struct Leaf : Node {
+        Leaf *prev;
+        Leaf *next;
+        alignas(T) unsigned char storage[LEAF_CAPACITY * sizeof(T)];
+
+        T *keys() noexcept {
+            return reinterpret_cast<T *>(storage);
+        }
+
+        const T *keys() const noexcept {
+            return reinterpret_cast<const T *>(storage);
+        }
+    };
+
+    struct Inner : Node {
+        Node *children[INNER_CAPACITY + 1];
+        // the number of elements under each child
+        size_t counts[INNER_CAPACITY + 1];
+        alignas(T) unsigned char storage[INNER_CAPACITY * sizeof(T)];
+
+        T *keys() noexcept {
+            return reinterpret_cast<T *>(storage);
+        }
+
+        const T *keys() const noexcept {
+            return reinterpret_cast<const T *>(storage);
+        }
+    };
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    class const_iterator {
+        friend class BTreeSet<T, NodeSize>;
+    public:
+        typedef const T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        typedef ptrdiff_t difference_type;
+        typedef std::bidirectional_iterator_tag iterator_category;
+
+    private:
+        const Leaf *leaf;
+        size_t idx;
+        const BTreeSet<T, NodeSize> *set;
+
+        const_iterator(const Leaf *leaf, size_t idx, const BTreeSet<T, NodeSize> *set)
+                : leaf{leaf}, idx{idx}, set{set} {}
+
+    public:
+        const_iterator() : leaf{nullptr}, idx{0}, set{nullptr} {}
+
+        reference operator*() const {
+            return leaf->keys()[idx];
+        }
+
+        pointer operator->() const {
+            return leaf->keys() + idx;
+        }
+
+        const_iterator &operator++() {
+            if (++idx == leaf->count) {
+                leaf = leaf->next;
+                idx = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        const_iterator &operator--() {
+            if (!leaf) {
+                leaf = set->tail;
+                idx = leaf->count;
+            } else if (idx == 0) {
+                leaf = leaf->prev;
+                idx = leaf->count;
+            }
+            --idx;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator temp(*this);
+            --*this;
+            return temp;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return leaf == other.leaf && idx == other.idx;
+        }
+
+        bool operator!=(const const_iterator &other) const {
+            return !(*this == other);
+        }
+    };
+
+    // the elements cannot be changed in place, that would break the order
+    typedef const_iterator iterator;
+
+private:
+    Node *root;
+    Leaf *head;
+    Leaf *tail;
+    size_type size_;
+    MemoryResource *resource_;
+
+public:
+    // MARK: big 6 -d
+    BTreeSet();
+
+    explicit BTreeSet(MemoryResource *resource);
+
+    BTreeSet(const Vector<T> &elements);
+
+    BTreeSet(Vector<T> &&elements);
+
+    BTreeSet(const BTreeSet<T, NodeSize> &other);
+
+    BTreeSet(const BTreeSet<T, NodeSize> &other, MemoryResource *resource);
+
+    BTreeSet(BTreeSet<T, NodeSize> &&other) noexcept;
+
+    BTreeSet<T, NodeSize> &operator=(const BTreeSet<T, NodeSize> &other);
+
+    BTreeSet<T, NodeSize> &operator=(BTreeSet<T, NodeSize> &&other) noexcept;
+
+    ~BTreeSet();
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const;
+
+    size_type size() const;
+
+    // the number of elements the current leaves can hold
+    size_type capacity() const;
+
+    // MARK: modifiers -d
+    void clear();
+
+    void add(const T &element);
+
+    void add(T &&element);
+
+    void remove(const T &element);
+
+    // MARK: lookup -d
+    bool contains(const T &element) const;
+
+    const_iterator find(const T &element) const;
+
+    // the first element not less than / greater than element
+    const_iterator lowerBound(const T &element) const;
+
+    const_iterator upperBound(const T &element) const;
+
+    Pair<const_iterator, const_iterator> equalRange(const T &element) const;
+
+    // the number of elements less than element
+    size_type rank(const T &element) const;
+
+    // the element with k smaller ones
+    const T &select(size_type k) const;
+
+    // the number of elements in [from, to)
+    size_type countInRange(const T &from, const T &to) const;
+
+    // MARK: iterators -d
+    const_iterator begin() const;
+
+    const_iterator cbegin() const;
+
+    const_iterator end() const;
+
+    const_iterator cend() const;
+
+private:
+    // MARK: big 6 helpers -d
+    void free();
+
+    void freeNode(Node *node) noexcept;
+
+    void copyFrom(const BTreeSet<T, NodeSize> &other);
+
+    void moveFrom(BTreeSet<T, NodeSize> &&other);
+
+    // MARK: node helpers -d
+    Leaf *newLeaf();
+
+    Inner *newInner();
+
+    size_type leafCount() const noexcept;
+
+    static size_type subtreeSize(const Node *node) noexcept;
+
+    // the leaf whose range covers element
+    const Leaf *leafFor(const T &element) const;
+
+    // position pos of leaf, one past its last key is the start of the next leaf
+    const_iterator iteratorAt(const Leaf *leaf, size_t pos) const;
+
+    template<class U>
+    void insert(U &&element);
+
+    // splits the full child i of parent into child i and a new child i + 1
+    void splitChild(Inner *parent, size_t i);
+
+    // makes sure child i of parent has more than the minimum and returns
+    // the index of the child that now covers the same keys
+    size_t refillChild(Inner *parent, size_t i);
+
+    void borrowFromLeft(Inner *parent, size_t i);
+
+    void borrowFromRight(Inner *parent, size_t i);
+
+    // merges child i + 1 of parent into child i
+    void mergeChildren(Inner *parent, size_t i);
+
+    static size_t minimum(const Node *node) noexcept;
+
+    // the first key not less than element / greater than element
+    static size_t lowerBound(const T *keys, size_t count, const T &element);
+
+    static size_t upperBound(const T *keys, size_t count, const T &element);
+
+    // relocates [first, last) to dest, the ranges may overlap
+    static void moveKeys(T *first, T *last, T *dest);
+};
+
+namespace kstd {
+    template<class T, size_t NodeSize>
+    struct is_trivially_relocatable<BTreeSet<T, NodeSize>> : std::true_type {};
+}
+
+// MARK: big 6 -i
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet() : BTreeSet<T, NodeSize>(defaultResource()) {}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(MemoryResource *resource)
+        : root{nullptr}, head{nullptr}, tail{nullptr}, size_{0}, resource_{resource} {}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(const Vector<T> &elements) : BTreeSet<T, NodeSize>() {
+    for (auto &element: elements) {
+        add(element);
+    }
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(Vector<T> &&elements) : BTreeSet<T, NodeSize>() {
+    for (auto &element: elements) {
+        add(std::move(element));
+    }
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(const BTreeSet<T, NodeSize> &other)
+        : BTreeSet<T, NodeSize>(other, defaultResource()) {}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(const BTreeSet<T, NodeSize> &other, MemoryResource *resource)
+        : BTreeSet<T, NodeSize>(resource) {
+    copyFrom(other);
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::BTreeSet(BTreeSet<T, NodeSize> &&other) noexcept
+        : BTreeSet<T, NodeSize>(other.resource_) {
+    moveFrom(std::move(other));
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize> &BTreeSet<T, NodeSize>::operator=(const BTreeSet<T, NodeSize> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize> &BTreeSet<T, NodeSize>::operator=(BTreeSet<T, NodeSize> &&other) noexcept {
+    if (this != &other) {
+        free();
+        resource_ = other.resource_;
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T, size_t NodeSize>
+BTreeSet<T, NodeSize>::~BTreeSet() {
+    free();
+}
+
+template<class T, size_t NodeSize>
+MemoryResource *BTreeSet<T, NodeSize>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: capacity -i
+template<class T, size_t NodeSize>
+bool BTreeSet<T, NodeSize>::empty() const {
+    return size_ == 0;
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::size() const {
+    return size_;
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::capacity() const {
+    return leafCount() * LEAF_CAPACITY;
+}
+
+// MARK: modifiers -i
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::clear() {
+    free();
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::add(const T &element) {
+    insert(element);
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::add(T &&element) {
+    insert(std::move(element));
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::remove(const T &element) {
+    if (!root) {
+        return;
+    }
+
+    Inner *path[MAX_DEPTH];
+    size_t slots[MAX_DEPTH];
+    size_t depth = 0;
+
+    Node *node = root;
+    while (!node->leaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        size_t i = refillChild(inner, upperBound(inner->keys(), inner->count, element));
+        node = inner->children[i];
+
+        // the root ran out of separators after a merge, its only child takes over
+        if (inner == root && inner->count == 0) {
+            root = node;
+            kstd::deallocate(resource_, inner, 1);
+        } else {
+            path[depth] = inner;
+            slots[depth++] = i;
+        }
+    }
+
+    Leaf *leaf = static_cast<Leaf *>(node);
+    size_t pos = lowerBound(leaf->keys(), leaf->count, element);
+    if (pos == leaf->count || element < leaf->keys()[pos]) {
+        return;
+    }
+
+    leaf->keys()[pos].~T();
+    moveKeys(leaf->keys() + pos + 1, leaf->keys() + leaf->count, leaf->keys() + pos);
+    leaf->count--;
+    size_--;
+    for (size_t d = 0; d < depth; ++d) {
+        path[d]->counts[slots[d]]--;
+    }
+
+    if (size_ == 0) {
+        free();
+    }
+}
+
+// MARK: lookup -i
+template<class T, size_t NodeSize>
+bool BTreeSet<T, NodeSize>::contains(const T &element) const {
+    return find(element) != cend();
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::find(const T &element) const {
+    if (!root) {
+        return cend();
+    }
+
+    const Leaf *leaf = leafFor(element);
+    size_t pos = lowerBound(leaf->keys(), leaf->count, element);
+    if (pos == leaf->count || element < leaf->keys()[pos]) {
+        return cend();
+    }
+    return const_iterator(leaf, pos, this);
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::lowerBound(const T &element) const {
+    if (!root) {
+        return cend();
+    }
+    const Leaf *leaf = leafFor(element);
+    return iteratorAt(leaf, lowerBound(leaf->keys(), leaf->count, element));
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::upperBound(const T &element) const {
+    if (!root) {
+        return cend();
+    }
+    const Leaf *leaf = leafFor(element);
+    return iteratorAt(leaf, upperBound(leaf->keys(), leaf->count, element));
+}
+
+template<class T, size_t NodeSize>
+Pair<typename BTreeSet<T, NodeSize>::const_iterator, typename BTreeSet<T, NodeSize>::const_iterator>
+BTreeSet<T, NodeSize>::equalRange(const T &element) const {
+    const_iterator first = lowerBound(element);
+    const_iterator last = first;
+    if (last != cend() && !(element < *last)) {
+        ++last;
+    }
+    return Pair<const_iterator, const_iterator>(first, last);
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::rank(const T &element) const {
+    if (!root) {
+        return 0;
+    }
+
+    // every child left of the one followed holds only smaller elements
+    size_type rank = 0;
+    const Node *node = root;
+    while (!node->leaf) {
+        const Inner *inner = static_cast<const Inner *>(node);
+        size_t i = upperBound(inner->keys(), inner->count, element);
+        for (size_t j = 0; j < i; ++j) {
+            rank += inner->counts[j];
+        }
+        node = inner->children[i];
+    }
+
+    const Leaf *leaf = static_cast<const Leaf *>(node);
+    return rank + lowerBound(leaf->keys(), leaf->count, element);
+}
+
+template<class T, size_t NodeSize>
+const T &BTreeSet<T, NodeSize>::select(size_type k) const {
+    if (k >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+
+    const Node *node = root;
+    while (!node->leaf) {
+        const Inner *inner = static_cast<const Inner *>(node);
+        size_t i = 0;
+        while (k >= inner->counts[i]) {
+            k -= inner->counts[i++];
+        }
+        node = inner->children[i];
+    }
+    return static_cast<const Leaf *>(node)->keys()[k];
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::countInRange(const T &from, const T &to) const {
+    if (!(from < to)) {
+        return 0;
+    }
+    return rank(to) - rank(from);
+}
+
+// MARK: iterators -i
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::begin() const {
+    return const_iterator(size_ == 0 ? nullptr : head, 0, this);
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::cbegin() const {
+    return begin();
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::end() const {
+    return const_iterator(nullptr, 0, this);
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::cend() const {
+    return end();
+}
+
+// MARK: big 6 helpers -i
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::free() {
+    if (root) {
+        freeNode(root);
+    }
+    root = nullptr;
+    head = tail = nullptr;
+    size_ = 0;
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::freeNode(Node *node) noexcept {
+    if (node->leaf) {
+        Leaf *leaf = static_cast<Leaf *>(node);
+        kstd::destroy(leaf->keys(), leaf->keys() + leaf->count);
+        kstd::deallocate(resource_, leaf, 1);
+        return;
+    }
+
+    Inner *inner = static_cast<Inner *>(node);
+    for (size_t i = 0; i <= inner->count; ++i) {
+        freeNode(inner->children[i]);
+    }
+    kstd::destroy(inner->keys(), inner->keys() + inner->count);
+    kstd::deallocate(resource_, inner, 1);
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::copyFrom(const BTreeSet<T, NodeSize> &other) {
+    // the elements arrive in order, so every insert goes to the rightmost leaf
+    for (const T &element: other) {
+        add(element);
+    }
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::moveFrom(BTreeSet<T, NodeSize> &&other) {
+    root = other.root;
+    head = other.head;
+    tail = other.tail;
+    size_ = other.size_;
+
+    other.root = nullptr;
+    other.head = other.tail = nullptr;
+    other.size_ = 0;
+}
+
+// MARK: node helpers -i
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::Leaf *BTreeSet<T, NodeSize>::newLeaf() {
+    Leaf *leaf = kstd::allocate<Leaf>(resource_, 1);
+    leaf->leaf = true;
+    leaf->count = 0;
+    leaf->prev = leaf->next = nullptr;
+    return leaf;
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::Inner *BTreeSet<T, NodeSize>::newInner() {
+    Inner *inner = kstd::allocate<Inner>(resource_, 1);
+    inner->leaf = false;
+    inner->count = 0;
+    return inner;
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::leafCount() const noexcept {
+    size_type count = 0;
+    for (const Leaf *leaf = head; leaf; leaf = leaf->next) {
+        ++count;
+    }
+    return count;
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::size_type BTreeSet<T, NodeSize>::subtreeSize(const Node *node) noexcept {
+    if (node->leaf) {
+        return node->count;
+    }
+
+    const Inner *inner = static_cast<const Inner *>(node);
+    size_type size = 0;
+    for (size_t i = 0; i <= inner->count; ++i) {
+        size += inner->counts[i];
+    }
+    return size;
+}
+
+template<class T, size_t NodeSize>
+const typename BTreeSet<T, NodeSize>::Leaf *BTreeSet<T, NodeSize>::leafFor(const T &element) const {
+    const Node *node = root;
+    while (!node->leaf) {
+        const Inner *inner = static_cast<const Inner *>(node);
+        node = inner->children[upperBound(inner->keys(), inner->count, element)];
+    }
+    return static_cast<const Leaf *>(node);
+}
+
+template<class T, size_t NodeSize>
+typename BTreeSet<T, NodeSize>::const_iterator BTreeSet<T, NodeSize>::iteratorAt(const Leaf *leaf, size_t pos) const {
+    if (pos == leaf->count) {
+        return const_iterator(leaf->next, 0, this);
+    }
+    return const_iterator(leaf, pos, this);
+}
+
+template<class T, size_t NodeSize>
+template<class U>
+void BTreeSet<T, NodeSize>::insert(U &&element) {
+    if (!root) {
+        head = tail = newLeaf();
+        root = head;
+    }
+
+    if (root->count == (root->leaf ? LEAF_CAPACITY : INNER_CAPACITY)) {
+        Inner *top = newInner();
+        top->children[0] = root;
+        top->counts[0] = size_;
+        root = top;
+        splitChild(top, 0);
+    }
+
+    // the counts on the path are only raised once the element turns out to be new
+    Inner *path[MAX_DEPTH];
+    size_t slots[MAX_DEPTH];
+    size_t depth = 0;
+
+    Node *node = root;
+    while (!node->leaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        size_t i = upperBound(inner->keys(), inner->count, element);
+        Node *child = inner->children[i];
+        if (child->count == (child->leaf ? LEAF_CAPACITY : INNER_CAPACITY)) {
+            splitChild(inner, i);
+            if (!(element < inner->keys()[i])) {
+                ++i;
+            }
+        }
+        path[depth] = inner;
+        slots[depth++] = i;
+        node = inner->children[i];
+    }
+
+    Leaf *leaf = static_cast<Leaf *>(node);
+    size_t pos = lowerBound(leaf->keys(), leaf->count, element);
+    if (pos < leaf->count && !(element < leaf->keys()[pos])) {
+        return;
+    }
+
+    moveKeys(leaf->keys() + pos, leaf->keys() + leaf->count, leaf->keys() + pos + 1);
+    new(leaf->keys() + pos) T(std::forward<U>(element));
+    leaf->count++;
+    size_++;
+    for (size_t d = 0; d < depth; ++d) {
+        path[d]->counts[slots[d]]++;
+    }
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::splitChild(Inner *parent, size_t i) {
+    Node *child = parent->children[i];
+    Node *right;
+    T *separator = parent->keys() + i;
+
+    // room for the new separator and child in the parent
+    moveKeys(parent->keys() + i, parent->keys() + parent->count, parent->keys() + i + 1);
+    std::memmove(parent->children + i + 2, parent->children + i + 1, (parent->count - i) * sizeof(Node *));
+    std::memmove(parent->counts + i + 2, parent->counts + i + 1, (parent->count - i) * sizeof(size_t));
+
+    if (child->leaf) {
+        Leaf *left = static_cast<Leaf *>(child);
+        Leaf *split = newLeaf();
+        size_t half = left->count / 2;
+
+        moveKeys(left->keys() + half, left->keys() + left->count, split->keys());
+        split->count = left->count - half;
+        left->count = half;
+
+        split->prev = left;
+        split->next = left->next;
+        if (left->next) {
+            left->next->prev = split;
+        } else {
+            tail = split;
+        }
+        left->next = split;
+
+        new(separator) T(split->keys()[0]);
+        right = split;
+    } else {
+        Inner *left = static_cast<Inner *>(child);
+        Inner *split = newInner();
+        size_t mid = left->count / 2;
+
+        moveKeys(left->keys() + mid + 1, left->keys() + left->count, split->keys());
+        std::memcpy(split->children, left->children + mid + 1, (left->count - mid) * sizeof(Node *));
+        std::memcpy(split->counts, left->counts + mid + 1, (left->count - mid) * sizeof(size_t));
+        split->count = left->count - mid - 1;
+
+        // the middle separator moves up instead of being copied
+        moveKeys(left->keys() + mid, left->keys() + mid + 1, separator);
+        left->count = mid;
+        right = split;
+    }
+
+    parent->children[i + 1] = right;
+    parent->counts[i + 1] = subtreeSize(right);
+    parent->counts[i] -= parent->counts[i + 1];
+    parent->count++;
+}
+
+template<class T, size_t NodeSize>
+size_t BTreeSet<T, NodeSize>::refillChild(Inner *parent, size_t i) {
+    Node *child = parent->children[i];
+    if (child->count > minimum(child)) {
+        return i;
+    }
+
+    if (i > 0 && parent->children[i - 1]->count > minimum(child)) {
+        borrowFromLeft(parent, i);
+        return i;
+    }
+    if (i < parent->count && parent->children[i + 1]->count > minimum(child)) {
+        borrowFromRight(parent, i);
+        return i;
+    }
+
+    if (i < parent->count) {
+        mergeChildren(parent, i);
+        return i;
+    }
+    mergeChildren(parent, i - 1);
+    return i - 1;
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::borrowFromLeft(Inner *parent, size_t i) {
+    Node *child = parent->children[i];
+    Node *sibling = parent->children[i - 1];
+    T *separator = parent->keys() + i - 1;
+
+    if (child->leaf) {
+        Leaf *to = static_cast<Leaf *>(child);
+        Leaf *from = static_cast<Leaf *>(sibling);
+
+        moveKeys(to->keys(), to->keys() + to->count, to->keys() + 1);
+        moveKeys(from->keys() + from->count - 1, from->keys() + from->count, to->keys());
+        from->count--;
+        to->count++;
+        *separator = to->keys()[0];
+        parent->counts[i - 1]--;
+        parent->counts[i]++;
+    } else {
+        Inner *to = static_cast<Inner *>(child);
+        Inner *from = static_cast<Inner *>(sibling);
+
+        moveKeys(to->keys(), to->keys() + to->count, to->keys() + 1);
+        std::memmove(to->children + 1, to->children, (to->count + 1) * sizeof(Node *));
+        std::memmove(to->counts + 1, to->counts, (to->count + 1) * sizeof(size_t));
+
+        // the separator comes down, the last key of the sibling goes up
+        moveKeys(separator, separator + 1, to->keys());
+        to->children[0] = from->children[from->count];
+        to->counts[0] = from->counts[from->count];
+        parent->counts[i - 1] -= to->counts[0];
+        parent->counts[i] += to->counts[0];
+        moveKeys(from->keys() + from->count - 1, from->keys() + from->count, separator);
+        from->count--;
+        to->count++;
+    }
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::borrowFromRight(Inner *parent, size_t i) {
+    Node *child = parent->children[i];
+    Node *sibling = parent->children[i + 1];
+    T *separator = parent->keys() + i;
+
+    if (child->leaf) {
+        Leaf *to = static_cast<Leaf *>(child);
+        Leaf *from = static_cast<Leaf *>(sibling);
+
+        moveKeys(from->keys(), from->keys() + 1, to->keys() + to->count);
+        moveKeys(from->keys() + 1, from->keys() + from->count, from->keys());
+        from->count--;
+        to->count++;
+        *separator = from->keys()[0];
+        parent->counts[i]++;
+        parent->counts[i + 1]--;
+    } else {
+        Inner *to = static_cast<Inner *>(child);
+        Inner *from = static_cast<Inner *>(sibling);
+
+        // the separator comes down, the first key of the sibling goes up
+        moveKeys(separator, separator + 1, to->keys() + to->count);
+        to->children[to->count + 1] = from->children[0];
+        to->counts[to->count + 1] = from->counts[0];
+        parent->counts[i] += from->counts[0];
+        parent->counts[i + 1] -= from->counts[0];
+        moveKeys(from->keys(), from->keys() + 1, separator);
+
+        moveKeys(from->keys() + 1, from->keys() + from->count, from->keys());
+        std::memmove(from->children, from->children + 1, from->count * sizeof(Node *));
+        std::memmove(from->counts, from->counts + 1, from->count * sizeof(size_t));
+        from->count--;
+        to->count++;
+    }
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::mergeChildren(Inner *parent, size_t i) {
+    Node *left = parent->children[i];
+    Node *right = parent->children[i + 1];
+    T *separator = parent->keys() + i;
+
+    if (left->leaf) {
+        Leaf *to = static_cast<Leaf *>(left);
+        Leaf *from = static_cast<Leaf *>(right);
+
+        moveKeys(from->keys(), from->keys() + from->count, to->keys() + to->count);
+        to->count += from->count;
+
+        to->next = from->next;
+        if (from->next) {
+            from->next->prev = to;
+        } else {
+            tail = to;
+        }
+        kstd::deallocate(resource_, from, 1);
+
+        separator->~T();
+    } else {
+        Inner *to = static_cast<Inner *>(left);
+        Inner *from = static_cast<Inner *>(right);
+
+        moveKeys(separator, separator + 1, to->keys() + to->count);
+        moveKeys(from->keys(), from->keys() + from->count, to->keys() + to->count + 1);
+        std::memcpy(to->children + to->count + 1, from->children, (from->count + 1) * sizeof(Node *));
+        std::memcpy(to->counts + to->count + 1, from->counts, (from->count + 1) * sizeof(size_t));
+        to->count += from->count + 1;
+        kstd::deallocate(resource_, from, 1);
+    }
+
+    moveKeys(parent->keys() + i + 1, parent->keys() + parent->count, parent->keys() + i);
+    std::memmove(parent->children + i + 1, parent->children + i + 2, (parent->count - i - 1) * sizeof(Node *));
+    parent->counts[i] += parent->counts[i + 1];
+    std::memmove(parent->counts + i + 1, parent->counts + i + 2, (parent->count - i - 1) * sizeof(size_t));
+    parent->count--;
+}
+
+template<class T, size_t NodeSize>
+size_t BTreeSet<T, NodeSize>::minimum(const Node *node) noexcept {
+    return node->leaf ? LEAF_MIN : INNER_MIN;
+}
+
+template<class T, size_t NodeSize>
+size_t BTreeSet<T, NodeSize>::lowerBound(const T *keys, size_t count, const T &element) {
+    size_t left = 0;
+    size_t right = count;
+
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+
+        if (keys[mid] < element) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    return left;
+}
+
+template<class T, size_t NodeSize>
+size_t BTreeSet<T, NodeSize>::upperBound(const T *keys, size_t count, const T &element) {
+    size_t left = 0;
+    size_t right = count;
+
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+
+        if (element < keys[mid]) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+
+    return left;
+}
+
+template<class T, size_t NodeSize>
+void BTreeSet<T, NodeSize>::moveKeys(T *first, T *last, T *dest) {
+    if constexpr (kstd::is_trivially_relocatable_v<T>) {
+        kstd::relocateOverlapping(first, last, dest);
+    } else if (dest < first) {
+        for (; first != last; ++first, ++dest) {
+            kstd::relocate(first, first + 1, dest);
+        }
+    } else {
+        dest += last - first;
+        while (last != first) {
+            --last;
+            --dest;
+            kstd::relocate(last, last + 1, dest);
+        }
+    }
+}
@@ -1,16 +1,18 @@
 #include "Bitset.h"
 #include <utility>
 
-Bitset::Bitset(value_type max)
-        : max{max}, count{0} {
-    data = new Bucket[bucketCount()]{};
+Bitset::Bitset(value_type max, MemoryResource *resource)
+        : max{max}, count{0}, resource_{resource} {
+    data = allocate(bucketCount());
 }
 
-Bitset::Bitset(const Bitset &other) {
+Bitset::Bitset(const Bitset &other) : Bitset(other, defaultResource()) {}
+
+Bitset::Bitset(const Bitset &other, MemoryResource *resource) : resource_{resource} {
     copyFrom(other);
 }
 
-Bitset::Bitset(Bitset &&other) noexcept {
+Bitset::Bitset(Bitset &&other) noexcept : resource_{other.resource_} {
     moveFrom(std::move(other));
 }
 
@@ -25,6 +27,7 @@ Bitset &Bitset::operator=(const Bitset &other) {
 Bitset &Bitset::operator=(Bitset &&other) noexcept {
     if (this != &other) {
         free();
+        resource_ = other.resource_;
         moveFrom(std::move(other));
     }
     return *this;
@@ -51,6 +54,10 @@ Bitset::value_type Bitset::capacity() const {
     return max;
 }
 
+MemoryResource *Bitset::resource() const {
+    return resource_;
+}
+
 void Bitset::clear() {
     for (size_type b = 0; b < bucketCount(); ++b) {
         data[b] = 0;
@@ -85,17 +92,31 @@ bool Bitset::contains(Bitset::value_type num) const {
     return data[bucket(num)] & position(num);
 }
 
+Bitset::Bucket *Bitset::allocate(size_type buckets) {
+    auto memory = static_cast<Bucket *>(resource_->allocate(buckets * sizeof(Bucket), alignof(Bucket)));
+    for (size_type b = 0; b < buckets; ++b) {
+        memory[b] = 0;
+    }
+    return memory;
+}
+
+void Bitset::deallocate(Bucket *buckets, size_type bucketsCount) {
+    if (buckets) {
+        resource_->deallocate(buckets, bucketsCount * sizeof(Bucket), alignof(Bucket));
+    }
+}
+
 void Bitset::free() {
-    delete[] data;
+    deallocate(data, bucketCount());
     data = nullptr;
 }
 
 void Bitset::copyFrom(const Bitset &other) {
     max = other.max;
-    count = other.max;
+    count = other.count;
 
     size_type buckets = bucketCount();
-    data = new Bucket[buckets];
+    data = allocate(buckets);
     for (size_type b = 0; b < buckets; ++b) {
         data[b] = other.data[b];
     }
@@ -103,26 +124,26 @@ void Bitset::copyFrom(const Bitset &other) {
 
 void Bitset::moveFrom(Bitset &&other) {
     max = other.max;
-    count = other.max;
+    count = other.count;
 
     data = other.data;
     other.data = nullptr;
 }
 
 void Bitset::resize(Bitset::value_type newMax) {
-    if (bucket(newMax) <= bucketCount()) {
+    if (bucket(newMax) < bucketCount()) {
         max = newMax;
         return;
     }
 
     size_type oldCount = bucketCount();
     max = newMax;
-    auto temp = new Bucket[bucketCount()]{};
+    auto temp = allocate(bucketCount());
     for (size_type b = 0; b < oldCount; ++b) {
         temp[b] = data[b];
     }
 
-    free();
+    deallocate(data, oldCount);
     data = temp;
 }
 
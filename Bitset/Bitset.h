@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
 class Bitset {
 public:
@@ -18,12 +20,15 @@ private:
     Bucket *data;
     value_type max;
     size_type count;
+    MemoryResource *resource_;
 
 public:
-    explicit Bitset(value_type max);
+    explicit Bitset(value_type max, MemoryResource *resource = defaultResource());
 
     Bitset(const Bitset &other);
 
+    Bitset(const Bitset &other, MemoryResource *resource);
+
     Bitset(Bitset &&other) noexcept;
 
     Bitset &operator=(const Bitset &other);
@@ -39,6 +44,8 @@ public:
 
     value_type capacity() const;
 
+    MemoryResource *resource() const;
+
     // modifiers
     void clear();
 
@@ -50,6 +57,10 @@ public:
     bool contains(value_type num) const;
 
 private:
+    Bucket *allocate(size_type buckets);
+
+    void deallocate(Bucket *buckets, size_type bucketsCount);
+
     void free();
 
     void copyFrom(const Bitset &other);
@@ -63,4 +74,9 @@ private:
     size_type bucket(value_type num) const;
 
     position_idx position(value_type num) const;
-};
\ No newline at end of file
+};
+
+namespace kstd {
+    template<>
+    struct is_trivially_relocatable<Bitset> : std::true_type {};
+}
\ No newline at end of file
@@ -9,20 +9,23 @@ const short MultiBitset::BITS_IN_BUCKET = sizeof(Bucket) * MultiBitset::BITS_IN_
 
 MultiBitset::MultiBitset() : MultiBitset(DEFAULT_N, DEFAULT_K) {}
 
-MultiBitset::MultiBitset(MultiBitset::value_type n, MultiBitset::bits k)
+MultiBitset::MultiBitset(MultiBitset::value_type n, MultiBitset::bits k, MemoryResource *resource)
         : maxNumber(n),
           bitsPerNumber(k),
           maxNumCount((1 << k) - 1),
           bucketsCount(bucketCount(n)),
           numsInBucket(BITS_IN_BUCKET / k),
-          buckets(new Bucket[bucketsCount]{}) {
+          resource_(resource),
+          buckets(allocate(bucketsCount)) {
 }
 
-MultiBitset::MultiBitset(const MultiBitset &other) {
+MultiBitset::MultiBitset(const MultiBitset &other) : MultiBitset(other, defaultResource()) {}
+
+MultiBitset::MultiBitset(const MultiBitset &other, MemoryResource *resource) : resource_(resource) {
     copyFrom(other);
 }
 
-MultiBitset::MultiBitset(MultiBitset &&other) noexcept {
+MultiBitset::MultiBitset(MultiBitset &&other) noexcept : resource_(other.resource_) {
     moveFrom(std::move(other));
 }
 
@@ -38,6 +41,7 @@ MultiBitset &MultiBitset::operator=(const MultiBitset &other) {
 MultiBitset &MultiBitset::operator=(MultiBitset &&other) noexcept {
     if (this != &other) {
         free();
+        resource_ = other.resource_;
         moveFrom(std::move(other));
     }
 
@@ -52,6 +56,10 @@ MultiBitset::value_type MultiBitset::getMaxNumber() const {
     return maxNumber;
 }
 
+MemoryResource *MultiBitset::resource() const {
+    return resource_;
+}
+
 void MultiBitset::insert(MultiBitset::value_type num) {
     value_type numCount = count(num);
     if (num > maxNumber || numCount == maxNumCount) {
@@ -150,8 +158,18 @@ MultiBitset::bits MultiBitset::rightBitsShift(MultiBitset::bits rightBits) {
     return BITS_IN_BUCKET - rightBits;
 }
 
+MultiBitset::Bucket *MultiBitset::allocate(MultiBitset::value_type count) {
+    auto memory = static_cast<Bucket *>(resource_->allocate(count * sizeof(Bucket), alignof(Bucket)));
+    for (value_type i = 0; i < count; ++i) {
+        memory[i] = 0;
+    }
+    return memory;
+}
+
 void MultiBitset::free() {
-    delete[] buckets;
+    if (buckets) {
+        resource_->deallocate(buckets, bucketsCount * sizeof(Bucket), alignof(Bucket));
+    }
     buckets = nullptr;
 }
 
@@ -162,7 +180,7 @@ void MultiBitset::copyFrom(const MultiBitset &other) {
     bucketsCount = other.bucketsCount;
     bitsPerNumber = other.bitsPerNumber;
 
-    buckets = new Bucket[bucketsCount];
+    buckets = allocate(bucketsCount);
     for (value_type i = 0; i < bucketsCount; ++i) {
         buckets[i] = other.buckets[i];
     }
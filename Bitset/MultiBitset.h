@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <iostream>
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
 class MultiBitset {
 public:
@@ -20,15 +22,18 @@ private:
     value_type numsInBucket;
     value_type maxNumCount;
     value_type bucketsCount;
+    MemoryResource *resource_;
     Bucket *buckets;
 
 public:
     MultiBitset();
 
-    MultiBitset(value_type n, bits k);
+    MultiBitset(value_type n, bits k, MemoryResource *resource = defaultResource());
 
     MultiBitset(const MultiBitset &other);
 
+    MultiBitset(const MultiBitset &other, MemoryResource *resource);
+
     MultiBitset(MultiBitset &&other) noexcept;
 
     MultiBitset &operator=(const MultiBitset &other);
@@ -39,6 +44,8 @@ public:
 
     value_type getMaxNumber() const;
 
+    MemoryResource *resource() const;
+
     void insert(value_type num);
 
     void remove(value_type num);
@@ -52,6 +59,8 @@ public:
     friend MultiBitset complement(const MultiBitset &multiBitset);
 
 private:
+    Bucket *allocate(value_type count);
+
     void free();
 
     void copyFrom(const MultiBitset &other);
@@ -81,6 +90,11 @@ private:
     static bits rightBitsShift(bits remainder);
 };
 
+namespace kstd {
+    template<>
+    struct is_trivially_relocatable<MultiBitset> : std::true_type {};
+}
+
 std::ostream &operator<<(std::ostream &os, const MultiBitset &multiset);
 
 MultiBitset intersection(const MultiBitset &lhs, const MultiBitset &rhs);
@@ -13,11 +13,14 @@ ThreeMultiSet::ThreeMultiSet() : ThreeMultiSet(DEFAULT_U) {
 }
 
 
-ThreeMultiSet::ThreeMultiSet(size_t u) : u(u), size(bucket(u - 1) + 1) {
-    buckets = new Bucket[size] {};
+ThreeMultiSet::ThreeMultiSet(size_t u, MemoryResource *resource)
+        : u(u), size(bucket(u - 1) + 1), resource_(resource) {
+    buckets = allocate(size);
 }
 
-ThreeMultiSet::ThreeMultiSet(const ThreeMultiSet &other) {
+ThreeMultiSet::ThreeMultiSet(const ThreeMultiSet &other) : ThreeMultiSet(other, defaultResource()) {}
+
+ThreeMultiSet::ThreeMultiSet(const ThreeMultiSet &other, MemoryResource *resource) : resource_(resource) {
     copyFrom(other);
 }
 
@@ -37,6 +40,10 @@ size_t ThreeMultiSet::getU() const {
     return u;
 }
 
+MemoryResource *ThreeMultiSet::resource() const {
+    return resource_;
+}
+
 void ThreeMultiSet::insert(size_t num) {
     int countNum = count(num);
     if (num >= u || countNum == MAX_COUNT_OF_NUMBER) {
@@ -74,8 +81,18 @@ void ThreeMultiSet::printAll() const {
     }
 }
 
+ThreeMultiSet::Bucket *ThreeMultiSet::allocate(size_t count) {
+    auto memory = static_cast<Bucket *>(resource_->allocate(count * sizeof(Bucket), alignof(Bucket)));
+    for (size_t i = 0; i < count; ++i) {
+        memory[i] = 0;
+    }
+    return memory;
+}
+
 void ThreeMultiSet::free() {
-    delete[] buckets;
+    if (buckets) {
+        resource_->deallocate(buckets, size * sizeof(Bucket), alignof(Bucket));
+    }
     buckets = nullptr;
     size = u = 0;
 }
@@ -83,7 +100,7 @@ void ThreeMultiSet::free() {
 void ThreeMultiSet::copyFrom(const ThreeMultiSet &other) {
     size = other.size;
     u = other.u;
-    buckets = new Bucket[size];
+    buckets = allocate(size);
 
     for (size_t i = 0; i < size; ++i) {
         buckets[i] = other.buckets[i];
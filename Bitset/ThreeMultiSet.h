@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
 
 class ThreeMultiSet {
@@ -17,20 +19,25 @@ private:
     Bucket *buckets;
     size_t size;
     size_t u;
+    MemoryResource *resource_;
 
 public:
     ThreeMultiSet();
 
-    explicit ThreeMultiSet(size_t u);
+    explicit ThreeMultiSet(size_t u, MemoryResource *resource = defaultResource());
 
     ThreeMultiSet(const ThreeMultiSet &other);
 
+    ThreeMultiSet(const ThreeMultiSet &other, MemoryResource *resource);
+
     ThreeMultiSet &operator=(const ThreeMultiSet &other);
 
     ~ThreeMultiSet();
 
     size_t getU() const;
 
+    MemoryResource *resource() const;
+
     void insert(size_t num);
 
     void remove(size_t num);
@@ -42,6 +49,8 @@ public:
     friend ThreeMultiSet intersect(const ThreeMultiSet &lhs, const ThreeMultiSet &rhs);
 
 private:
+    Bucket *allocate(size_t count);
+
     void free();
 
     void copyFrom(const ThreeMultiSet &other);
@@ -55,4 +64,9 @@ private:
     static size_t shift(size_t num);
 };
 
+namespace kstd {
+    template<>
+    struct is_trivially_relocatable<ThreeMultiSet> : std::true_type {};
+}
+
 ThreeMultiSet intersect(const ThreeMultiSet &lhs, const ThreeMultiSet &rhs);
\ No newline at end of file
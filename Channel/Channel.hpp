@@ -0,0 +1,376 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "../Queue/Queue.hpp"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define KSTD_CHANNEL_COROUTINES 1
+#endif
+
+/*
+ * Queue shared between threads that park while there is nothing to do
+ *
+ * a capacity of 0 makes the channel unbounded, otherwise push waits for room
+ * waiting threads sleep on a condition variable and are woken by the opposite operation
+ *
+ * close() wakes everybody, later pushes fail and pops drain what is left
+ * and then fail as well
+ *
+ * with C++20 coroutines `co_await channel.pop()` suspends the coroutine instead of the thread,
+ * an element pushed to a channel with a suspended coroutine is handed to it directly
+ * and the coroutine is resumed on the pushing thread
+ *
+ * a suspended coroutine may be destroyed, it stops waiting on the channel,
+ * destroying the channel closes it and resumes the coroutines still waiting with nothing
+ */
+template<class T>
+class Channel {
+private:
+#ifdef KSTD_CHANNEL_COROUTINES
+    class PopAwaiter;
+#endif
+
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    Queue<T> elements;
+    size_t capacity_;
+    bool closed_;
+
+#ifdef KSTD_CHANNEL_COROUTINES
+    // suspended coroutines in the order they started waiting
+    PopAwaiter *firstWaiter;
+    PopAwaiter *lastWaiter;
+#endif
+
+public:
+    explicit Channel(size_t capacity = 0, MemoryResource *resource = defaultResource());
+
+    Channel(const Channel<T> &other) = delete;
+
+    Channel<T> &operator=(const Channel<T> &other) = delete;
+
+    ~Channel();
+
+    // MARK: producers -d
+    // waits while a bounded channel is full, returns false when it is closed
+    bool push(const T &element);
+
+    bool push(T &&element);
+
+    bool tryPush(const T &element);
+
+    bool tryPush(T &&element);
+
+    // MARK: consumers -d
+    // waits for an element, returns false once the channel is closed and empty
+    bool pop(T &element);
+
+    bool tryPop(T &element);
+
+    template<class Rep, class Period>
+    bool popFor(T &element, const std::chrono::duration<Rep, Period> &timeout);
+
+    template<class Clock, class Duration>
+    bool popUntil(T &element, const std::chrono::time_point<Clock, Duration> &deadline);
+
+#ifdef KSTD_CHANNEL_COROUTINES
+    // co_await gives the next element, or nothing once the channel is closed and empty
+    PopAwaiter pop() noexcept;
+#endif
+
+    // MARK: state -d
+    void close();
+
+    bool closed() const;
+
+    bool empty() const;
+
+    size_t size() const;
+
+    size_t capacity() const noexcept;
+
+private:
+    template<class U>
+    bool pushImpl(U &&element, bool wait);
+
+    // takes the front element, the mutex must be held and the queue not empty
+    void take(T &element);
+
+#ifdef KSTD_CHANNEL_COROUTINES
+    // removes the first suspended coroutine, the mutex must be held
+    PopAwaiter *takeWaiter() noexcept;
+
+    // removes a suspended coroutine from anywhere in the list, the mutex must be held
+    void unlinkWaiter(PopAwaiter *waiter) noexcept;
+#endif
+};
+
+#ifdef KSTD_CHANNEL_COROUTINES
+template<class T>
+class Channel<T>::PopAwaiter {
+    friend class Channel<T>;
+
+    Channel<T> *channel;
+    std::optional<T> element;
+    std::coroutine_handle<> handle;
+    PopAwaiter *next;
+    // whether the awaiter is linked into the waiters, guarded by the mutex of the channel
+    bool queued;
+
+    explicit PopAwaiter(Channel<T> *channel) noexcept
+            : channel{channel}, element{}, handle{}, next{nullptr}, queued{false} {}
+
+public:
+    PopAwaiter(const PopAwaiter &other) = delete;
+
+    PopAwaiter &operator=(const PopAwaiter &other) = delete;
+
+    // a coroutine destroyed while suspended must not stay reachable from the channel
+    ~PopAwaiter() {
+        if (handle) {
+            std::lock_guard<std::mutex> lock(channel->mutex);
+            if (queued) {
+                channel->unlinkWaiter(this);
+            }
+        }
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> waiting) {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (!channel->elements.empty()) {
+            element.emplace(std::move(channel->elements.peek()));
+            channel->elements.pop();
+            channel->notFull.notify_one();
+            return false;
+        }
+        if (channel->closed_) {
+            return false;
+        }
+
+        handle = waiting;
+        queued = true;
+        if (channel->lastWaiter) {
+            channel->lastWaiter->next = this;
+        } else {
+            channel->firstWaiter = this;
+        }
+        channel->lastWaiter = this;
+        return true;
+    }
+
+    std::optional<T> await_resume() {
+        return std::move(element);
+    }
+};
+#endif
+
+template<class T>
+Channel<T>::Channel(size_t capacity, MemoryResource *resource)
+        : elements(resource), capacity_{capacity}, closed_{false}
+#ifdef KSTD_CHANNEL_COROUTINES
+        , firstWaiter{nullptr}, lastWaiter{nullptr}
+#endif
+{}
+
+template<class T>
+Channel<T>::~Channel() {
+    close();
+}
+
+// MARK: producers -i
+template<class T>
+bool Channel<T>::push(const T &element) {
+    return pushImpl(element, true);
+}
+
+template<class T>
+bool Channel<T>::push(T &&element) {
+    return pushImpl(std::move(element), true);
+}
+
+template<class T>
+bool Channel<T>::tryPush(const T &element) {
+    return pushImpl(element, false);
+}
+
+template<class T>
+bool Channel<T>::tryPush(T &&element) {
+    return pushImpl(std::move(element), false);
+}
+
+// MARK: consumers -i
+template<class T>
+bool Channel<T>::pop(T &element) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this]() { return !elements.empty() || closed_; });
+    if (elements.empty()) {
+        return false;
+    }
+    take(element);
+    return true;
+}
+
+template<class T>
+bool Channel<T>::tryPop(T &element) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (elements.empty()) {
+        return false;
+    }
+    take(element);
+    return true;
+}
+
+template<class T>
+template<class Rep, class Period>
+bool Channel<T>::popFor(T &element, const std::chrono::duration<Rep, Period> &timeout) {
+    return popUntil(element, std::chrono::steady_clock::now() + timeout);
+}
+
+template<class T>
+template<class Clock, class Duration>
+bool Channel<T>::popUntil(T &element, const std::chrono::time_point<Clock, Duration> &deadline) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!notEmpty.wait_until(lock, deadline, [this]() { return !elements.empty() || closed_; })) {
+        return false;
+    }
+    if (elements.empty()) {
+        return false;
+    }
+    take(element);
+    return true;
+}
+
+#ifdef KSTD_CHANNEL_COROUTINES
+template<class T>
+typename Channel<T>::PopAwaiter Channel<T>::pop() noexcept {
+    return PopAwaiter(this);
+}
+#endif
+
+// MARK: state -i
+template<class T>
+void Channel<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed_ = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+
+#ifdef KSTD_CHANNEL_COROUTINES
+    // the queue is empty while coroutines wait, so they all resume with nothing,
+    // one at a time because a resumed coroutine may destroy another waiting one
+    while (true) {
+        PopAwaiter *waiter;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            waiter = takeWaiter();
+        }
+        if (!waiter) {
+            break;
+        }
+        waiter->handle.resume();
+    }
+#endif
+}
+
+template<class T>
+bool Channel<T>::closed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return closed_;
+}
+
+template<class T>
+bool Channel<T>::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return elements.empty();
+}
+
+template<class T>
+size_t Channel<T>::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return elements.size();
+}
+
+template<class T>
+size_t Channel<T>::capacity() const noexcept {
+    return capacity_;
+}
+
+// MARK: helpers -i
+template<class T>
+template<class U>
+bool Channel<T>::pushImpl(U &&element, bool wait) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (wait && capacity_ > 0) {
+        notFull.wait(lock, [this]() { return elements.size() < capacity_ || closed_; });
+    }
+    if (closed_ || (capacity_ > 0 && elements.size() >= capacity_)) {
+        return false;
+    }
+
+#ifdef KSTD_CHANNEL_COROUTINES
+    if (PopAwaiter *waiter = takeWaiter()) {
+        waiter->element.emplace(std::forward<U>(element));
+        lock.unlock();
+        waiter->handle.resume();
+        return true;
+    }
+#endif
+
+    elements.push(std::forward<U>(element));
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+template<class T>
+void Channel<T>::take(T &element) {
+    element = std::move(elements.peek());
+    elements.pop();
+    notFull.notify_one();
+}
+
+#ifdef KSTD_CHANNEL_COROUTINES
+template<class T>
+typename Channel<T>::PopAwaiter *Channel<T>::takeWaiter() noexcept {
+    PopAwaiter *waiter = firstWaiter;
+    if (waiter) {
+        firstWaiter = waiter->next;
+        if (!firstWaiter) {
+            lastWaiter = nullptr;
+        }
+        waiter->queued = false;
+    }
+    return waiter;
+}
+
+template<class T>
+void Channel<T>::unlinkWaiter(PopAwaiter *waiter) noexcept {
+    PopAwaiter *previous = nullptr;
+    for (PopAwaiter *it = firstWaiter; it != waiter; it = it->next) {
+        previous = it;
+    }
+
+    if (previous) {
+        previous->next = waiter->next;
+    } else {
+        firstWaiter = waiter->next;
+    }
+    if (lastWaiter == waiter) {
+        lastWaiter = previous;
+    }
+    waiter->queued = false;
+}
+#endif
@@ -0,0 +1,661 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "../Algorithm/Algorithm.hpp"
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../SegmentedVector/SegmentedVector.hpp"
+
+/*
+ * double ended queue made of fixed size blocks
+ *
+ * the blocks are listed in a map, a ring of block pointers like the ring of Queue,
+ * so a block can be added in front of the first one as cheaply as after the last one
+ * growing the map copies only the block pointers, the elements never move,
+ * so references to them stay valid until they are popped
+ *
+ * element i lives at position start + i counted over all blocks,
+ * start is where the first element sits inside the first block
+ *
+ * one emptied block is kept as a spare, so pushing and popping
+ * back and forth over a block boundary does not allocate every time
+ */
+template<class D, class V>
+class DequeIterator {
+public:
+    typedef V value_type;
+    typedef V *pointer;
+    typedef V &reference;
+    typedef ptrdiff_t difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+
+private:
+    D *owner;
+    size_t idx;
+
+public:
+    DequeIterator(D *owner = nullptr, size_t idx = 0) : owner{owner}, idx{idx} {}
+
+    reference operator*() const {
+        return (*owner)[idx];
+    }
+
+    pointer operator->() const {
+        return &operator*();
+    }
+
+    DequeIterator &operator++() {
+        ++idx;
+        return *this;
+    }
+
+    DequeIterator operator++(int) {
+        DequeIterator temp(*this);
+        ++idx;
+        return temp;
+    }
+
+    DequeIterator &operator--() {
+        --idx;
+        return *this;
+    }
+
+    DequeIterator operator--(int) {
+        DequeIterator temp(*this);
+        --idx;
+        return temp;
+    }
+
+    DequeIterator &operator+=(difference_type d) {
+        idx += d;
+        return *this;
+    }
+
+    DequeIterator &operator-=(difference_type d) {
+        idx -= d;
+        return *this;
+    }
+
+    DequeIterator operator+(difference_type d) const {
+        return DequeIterator(owner, idx + d);
+    }
+
+    DequeIterator operator-(difference_type d) const {
+        return DequeIterator(owner, idx - d);
+    }
+
+    difference_type operator-(const DequeIterator &other) const {
+        return difference_type(idx) - difference_type(other.idx);
+    }
+
+    reference operator[](difference_type d) const {
+        return (*owner)[idx + d];
+    }
+
+    size_t index() const {
+        return idx;
+    }
+
+    bool operator==(const DequeIterator &other) const {
+        return idx == other.idx;
+    }
+
+    bool operator!=(const DequeIterator &other) const {
+        return idx != other.idx;
+    }
+
+    bool operator<(const DequeIterator &other) const {
+        return idx < other.idx;
+    }
+
+    bool operator<=(const DequeIterator &other) const {
+        return idx <= other.idx;
+    }
+
+    bool operator>(const DequeIterator &other) const {
+        return idx > other.idx;
+    }
+
+    bool operator>=(const DequeIterator &other) const {
+        return idx >= other.idx;
+    }
+};
+
+template<class T, size_t BlockSize = defaultChunkSize<T>()>
+class Deque {
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "the block size must be a power of two");
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef DequeIterator<Deque<T, BlockSize>, value_type> iterator;
+    typedef DequeIterator<const Deque<T, BlockSize>, const value_type> const_iterator;
+
+private:
+    pointer *map;
+    size_type mapCapacity;
+    size_type firstBlock;
+    size_type blockCount;
+    size_type start;
+    size_type size_;
+    pointer spare;
+    MemoryResource *resource_;
+
+    static const size_type INITIAL_MAP_CAPACITY = 4;
+
+public:
+    // MARK: big 6 -d
+    Deque();
+
+    explicit Deque(MemoryResource *resource);
+
+    Deque(std::initializer_list<value_type> data, MemoryResource *resource = defaultResource());
+
+    Deque(const Deque<T, BlockSize> &other);
+
+    Deque(const Deque<T, BlockSize> &other, MemoryResource *resource);
+
+    Deque(Deque<T, BlockSize> &&other) noexcept;
+
+    Deque<T, BlockSize> &operator=(const Deque<T, BlockSize> &other);
+
+    Deque<T, BlockSize> &operator=(Deque<T, BlockSize> &&other) noexcept;
+
+    ~Deque();
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: element access -d
+    const_reference at(size_type idx) const;
+
+    reference at(size_type idx);
+
+    const_reference operator[](size_type idx) const;
+
+    reference operator[](size_type idx);
+
+    const_reference front() const;
+
+    reference front();
+
+    const_reference back() const;
+
+    reference back();
+
+    // MARK: iterators -d
+    const_iterator begin() const noexcept;
+
+    iterator begin() noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator cend() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type blocks() const noexcept;
+
+    // gives back the spare block, and every block when the deque is empty
+    void shrinkToFit();
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    void pushBack(const T &value);
+
+    void pushBack(T &&value);
+
+    template<class... Args>
+    reference emplaceBack(Args &&... args);
+
+    void pushFront(const T &value);
+
+    void pushFront(T &&value);
+
+    template<class... Args>
+    reference emplaceFront(Args &&... args);
+
+    void popBack();
+
+    void popFront();
+
+    void swap(Deque<T, BlockSize> &other);
+
+private:
+    // MARK: big 6 helpers -d
+    void free();
+
+    void copyFrom(const Deque<T, BlockSize> &other);
+
+    void moveFrom(Deque<T, BlockSize> &&other);
+
+    // MARK: storage helpers -d
+    pointer &block(size_type b) const noexcept;
+
+    pointer slot(size_type position) const noexcept;
+
+    pointer newBlock();
+
+    void releaseBlock(pointer b) noexcept;
+
+    void growMap();
+
+    void addBlockBack();
+
+    void addBlockFront();
+
+    // an empty deque keeps one block and starts filling it from the beginning
+    void startOver() noexcept;
+};
+
+namespace kstd {
+    template<class T, size_t BlockSize>
+    struct is_trivially_relocatable<Deque<T, BlockSize>> : std::true_type {};
+}
+
+// MARK: big 6 -i
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque() : Deque<T, BlockSize>(defaultResource()) {}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque(MemoryResource *resource)
+        : map{nullptr}, mapCapacity{0}, firstBlock{0}, blockCount{0}, start{0}, size_{0},
+          spare{nullptr}, resource_{resource} {}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque(std::initializer_list<value_type> data, MemoryResource *resource)
+        : Deque<T, BlockSize>(resource) {
+    for (auto el = data.begin(); el != data.end(); ++el) {
+        emplaceBack(*el);
+    }
+}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque(const Deque<T, BlockSize> &other) : Deque<T, BlockSize>(other, defaultResource()) {}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque(const Deque<T, BlockSize> &other, MemoryResource *resource)
+        : Deque<T, BlockSize>(resource) {
+    copyFrom(other);
+}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::Deque(Deque<T, BlockSize> &&other) noexcept : Deque<T, BlockSize>(other.resource_) {
+    moveFrom(std::move(other));
+}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize> &Deque<T, BlockSize>::operator=(const Deque<T, BlockSize> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize> &Deque<T, BlockSize>::operator=(Deque<T, BlockSize> &&other) noexcept {
+    if (this != &other) {
+        free();
+        resource_ = other.resource_;
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T, size_t BlockSize>
+Deque<T, BlockSize>::~Deque() {
+    free();
+}
+
+template<class T, size_t BlockSize>
+MemoryResource *Deque<T, BlockSize>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: element access -i
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_reference Deque<T, BlockSize>::at(size_type idx) const {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::at(size_type idx) {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_reference Deque<T, BlockSize>::operator[](size_type idx) const {
+    return *slot(start + idx);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::operator[](size_type idx) {
+    return *slot(start + idx);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_reference Deque<T, BlockSize>::front() const {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    return operator[](0);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::front() {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    return operator[](0);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_reference Deque<T, BlockSize>::back() const {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    return operator[](size_ - 1);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::back() {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    return operator[](size_ - 1);
+}
+
+// MARK: iterators -i
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_iterator Deque<T, BlockSize>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::iterator Deque<T, BlockSize>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_iterator Deque<T, BlockSize>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_iterator Deque<T, BlockSize>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::iterator Deque<T, BlockSize>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::const_iterator Deque<T, BlockSize>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+// MARK: capacity -i
+template<class T, size_t BlockSize>
+bool Deque<T, BlockSize>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::size_type Deque<T, BlockSize>::size() const noexcept {
+    return size_;
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::size_type Deque<T, BlockSize>::blocks() const noexcept {
+    return blockCount;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::shrinkToFit() {
+    if (size_ == 0) {
+        while (blockCount > 0) {
+            kstd::deallocate(resource_, block(--blockCount), BlockSize);
+        }
+        start = 0;
+    }
+    if (spare) {
+        kstd::deallocate(resource_, spare, BlockSize);
+        spare = nullptr;
+    }
+}
+
+// MARK: modifiers -i
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::clear() noexcept {
+    for (size_type i = 0; i < size_; ++i) {
+        slot(start + i)->~T();
+    }
+    size_ = 0;
+    startOver();
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::pushBack(const T &value) {
+    emplaceBack(value);
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::pushBack(T &&value) {
+    emplaceBack(std::move(value));
+}
+
+template<class T, size_t BlockSize>
+template<class... Args>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::emplaceBack(Args &&... args) {
+    // existing elements never move, so args stay valid across a new block
+    size_type position = start + size_;
+    if (position == blockCount * BlockSize) {
+        addBlockBack();
+    }
+
+    pointer p = slot(position);
+    new(p) T(std::forward<Args>(args)...);
+    size_++;
+    return *p;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::pushFront(const T &value) {
+    emplaceFront(value);
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::pushFront(T &&value) {
+    emplaceFront(std::move(value));
+}
+
+template<class T, size_t BlockSize>
+template<class... Args>
+typename Deque<T, BlockSize>::reference Deque<T, BlockSize>::emplaceFront(Args &&... args) {
+    if (start == 0) {
+        addBlockFront();
+    }
+
+    pointer p = slot(start - 1);
+    new(p) T(std::forward<Args>(args)...);
+    start--;
+    size_++;
+    return *p;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::popBack() {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    size_--;
+    slot(start + size_)->~T();
+
+    if (size_ == 0) {
+        startOver();
+    } else if ((start + size_) % BlockSize == 0) {
+        // the last block is empty
+        releaseBlock(block(--blockCount));
+    }
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::popFront() {
+    if (empty()) {
+        throw std::length_error("deque is empty!");
+    }
+    slot(start)->~T();
+    start++;
+    size_--;
+
+    if (size_ == 0) {
+        startOver();
+    } else if (start == BlockSize) {
+        // the first block is empty
+        releaseBlock(block(0));
+        firstBlock = (firstBlock + 1) & (mapCapacity - 1);
+        blockCount--;
+        start = 0;
+    }
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::swap(Deque<T, BlockSize> &other) {
+    kstd::swap(map, other.map);
+    kstd::swap(mapCapacity, other.mapCapacity);
+    kstd::swap(firstBlock, other.firstBlock);
+    kstd::swap(blockCount, other.blockCount);
+    kstd::swap(start, other.start);
+    kstd::swap(size_, other.size_);
+    kstd::swap(spare, other.spare);
+    kstd::swap(resource_, other.resource_);
+}
+
+// MARK: big 6 helpers -i
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::free() {
+    clear();
+    shrinkToFit();
+    kstd::deallocate(resource_, map, mapCapacity);
+    map = nullptr;
+    mapCapacity = firstBlock = 0;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::copyFrom(const Deque<T, BlockSize> &other) {
+    for (size_type i = 0; i < other.size_; ++i) {
+        emplaceBack(other[i]);
+    }
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::moveFrom(Deque<T, BlockSize> &&other) {
+    map = other.map;
+    mapCapacity = other.mapCapacity;
+    firstBlock = other.firstBlock;
+    blockCount = other.blockCount;
+    start = other.start;
+    size_ = other.size_;
+    spare = other.spare;
+
+    other.map = nullptr;
+    other.spare = nullptr;
+    other.mapCapacity = other.firstBlock = other.blockCount = other.start = other.size_ = 0;
+}
+
+// MARK: storage helpers -i
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::pointer &Deque<T, BlockSize>::block(size_type b) const noexcept {
+    return map[(firstBlock + b) & (mapCapacity - 1)];
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::pointer Deque<T, BlockSize>::slot(size_type position) const noexcept {
+    return block(position / BlockSize) + position % BlockSize;
+}
+
+template<class T, size_t BlockSize>
+typename Deque<T, BlockSize>::pointer Deque<T, BlockSize>::newBlock() {
+    if (spare) {
+        pointer b = spare;
+        spare = nullptr;
+        return b;
+    }
+    return kstd::allocate<T>(resource_, BlockSize);
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::releaseBlock(pointer b) noexcept {
+    if (spare) {
+        kstd::deallocate(resource_, b, BlockSize);
+    } else {
+        spare = b;
+    }
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::growMap() {
+    size_type capacity = mapCapacity == 0 ? INITIAL_MAP_CAPACITY : 2 * mapCapacity;
+    pointer *bigger = kstd::allocate<pointer>(resource_, capacity);
+    for (size_type b = 0; b < blockCount; ++b) {
+        bigger[b] = block(b);
+    }
+
+    kstd::deallocate(resource_, map, mapCapacity);
+    map = bigger;
+    mapCapacity = capacity;
+    firstBlock = 0;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::addBlockBack() {
+    if (blockCount == mapCapacity) {
+        growMap();
+    }
+    block(blockCount) = newBlock();
+    blockCount++;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::addBlockFront() {
+    if (blockCount == mapCapacity) {
+        growMap();
+    }
+    pointer b = newBlock();
+    firstBlock = (firstBlock + mapCapacity - 1) & (mapCapacity - 1);
+    blockCount++;
+    block(0) = b;
+    start += BlockSize;
+}
+
+template<class T, size_t BlockSize>
+void Deque<T, BlockSize>::startOver() noexcept {
+    while (blockCount > 1) {
+        releaseBlock(block(--blockCount));
+    }
+    start = 0;
+}
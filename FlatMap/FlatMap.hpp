@@ -0,0 +1,548 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "../Algorithm/Algorithm.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../Pair/Pair.hpp"
+#include "../Simd/Simd.h"
+#include "../SoAVector/SoAVector.hpp"
+#include "../Span/Span.hpp"
+#include "../Vector/Vector.hpp"
+
+/*
+ * sorted map on two parallel Vectors
+ *
+ * the keys are kept apart from the values, so a lookup only walks the dense key array
+ * and touches the value once it is found, the search is the one OrderedSet uses
+ * inserting and removing shift both arrays and are O(n),
+ * the map is meant to be built in bulk and read a lot
+ *
+ * iterating gives SoARow proxies, first is the key and second the value
+ * keys are compared with < only, two keys are equal when neither is smaller
+ */
+template<class K, class V>
+class FlatMapIterator {
+    template<class, class> friend
+    class FlatMapIterator;
+
+public:
+    typedef SoARow<const K, V> value_type;
+    typedef SoARow<const K, V> reference;
+    typedef void pointer;
+    typedef ptrdiff_t difference_type;
+    typedef std::input_iterator_tag iterator_category;
+
+private:
+    const K *key;
+    V *value;
+
+public:
+    FlatMapIterator(const K *key = nullptr, V *value = nullptr) : key{key}, value{value} {}
+
+    // an iterator converts to a const_iterator
+    template<class U, class = std::enable_if_t<std::is_same_v<const U, V> && !std::is_same_v<U, V>>>
+    FlatMapIterator(const FlatMapIterator<K, U> &other) : key{other.key}, value{other.value} {}
+
+    reference operator*() const {
+        return reference(*key, *value);
+    }
+
+    reference operator[](difference_type d) const {
+        return reference(key[d], value[d]);
+    }
+
+    FlatMapIterator &operator++() {
+        ++key;
+        ++value;
+        return *this;
+    }
+
+    FlatMapIterator operator++(int) {
+        FlatMapIterator temp(*this);
+        ++*this;
+        return temp;
+    }
+
+    FlatMapIterator &operator--() {
+        --key;
+        --value;
+        return *this;
+    }
+
+    FlatMapIterator operator--(int) {
+        FlatMapIterator temp(*this);
+        --*this;
+        return temp;
+    }
+
+    FlatMapIterator &operator+=(difference_type d) {
+        key += d;
+        value += d;
+        return *this;
+    }
+
+    FlatMapIterator operator+(difference_type d) const {
+        return FlatMapIterator(key + d, value + d);
+    }
+
+    difference_type operator-(const FlatMapIterator &other) const {
+        return key - other.key;
+    }
+
+    bool operator==(const FlatMapIterator &other) const {
+        return key == other.key;
+    }
+
+    bool operator!=(const FlatMapIterator &other) const {
+        return key != other.key;
+    }
+
+    bool operator<(const FlatMapIterator &other) const {
+        return key < other.key;
+    }
+};
+
+template<class K, class V>
+class FlatMap {
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef SoARow<const K, V> row;
+    typedef SoARow<const K, const V> const_row;
+    typedef FlatMapIterator<K, V> iterator;
+    typedef FlatMapIterator<K, const V> const_iterator;
+
+private:
+    Vector<K> keys_;
+    Vector<V> values_;
+
+public:
+    // MARK: big 6 -d
+    FlatMap();
+
+    explicit FlatMap(MemoryResource *resource);
+
+    // pairs keys[i] with values[i] and sorts them by key, of equal keys the first one is kept
+    // keys that are already sorted are taken in O(n)
+    FlatMap(Vector<K> keys, Vector<V> values);
+
+    FlatMap(const FlatMap<K, V> &other) = default;
+
+    FlatMap(const FlatMap<K, V> &other, MemoryResource *resource);
+
+    FlatMap(FlatMap<K, V> &&other) noexcept = default;
+
+    FlatMap<K, V> &operator=(const FlatMap<K, V> &other) = default;
+
+    FlatMap<K, V> &operator=(FlatMap<K, V> &&other) noexcept = default;
+
+    ~FlatMap() = default;
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: element access -d
+    V &at(const K &key);
+
+    const V &at(const K &key) const;
+
+    // the value of key, a default constructed one is added if the key is missing
+    V &operator[](const K &key);
+
+    V &operator[](K &&key);
+
+    Span<const K> keys() const noexcept;
+
+    Span<const V> values() const noexcept;
+
+    Span<V> values() noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    void reserve(size_type capacity);
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    // adds key with value or overwrites the value of an existing key,
+    // second is true when the key was added
+    template<class M>
+    Pair<iterator, bool> insertOrAssign(const K &key, M &&value);
+
+    template<class M>
+    Pair<iterator, bool> insertOrAssign(K &&key, M &&value);
+
+    // builds the value from args only when the key is missing, an existing value is left alone
+    template<class... Args>
+    Pair<iterator, bool> tryEmplace(const K &key, Args &&... args);
+
+    template<class... Args>
+    Pair<iterator, bool> tryEmplace(K &&key, Args &&... args);
+
+    void remove(const K &key);
+
+    // MARK: lookup -d
+    bool contains(const K &key) const;
+
+    iterator find(const K &key);
+
+    const_iterator find(const K &key) const;
+
+    // the first entry whose key is not less than / greater than key
+    iterator lowerBound(const K &key);
+
+    const_iterator lowerBound(const K &key) const;
+
+    iterator upperBound(const K &key);
+
+    const_iterator upperBound(const K &key) const;
+
+    // MARK: iterators -d
+    iterator begin() noexcept;
+
+    const_iterator begin() const noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator end() const noexcept;
+
+    const_iterator cend() const noexcept;
+
+private:
+    // MARK: helpers -d
+    size_type position(const K &key) const;
+
+    // whether the key at the lower bound pos is key
+    bool matches(size_type pos, const K &key) const;
+
+    // index of key, size() if it is missing
+    size_type indexOf(const K &key) const;
+
+    iterator iteratorAt(size_type pos) noexcept;
+
+    const_iterator iteratorAt(size_type pos) const noexcept;
+
+    template<class KK, class... Args>
+    void emplaceAt(size_type pos, KK &&key, Args &&... args);
+
+    template<class KK, class M>
+    Pair<iterator, bool> assign(KK &&key, M &&value);
+
+    template<class KK, class... Args>
+    Pair<iterator, bool> emplaceMissing(KK &&key, Args &&... args);
+};
+
+namespace kstd {
+    template<class K, class V>
+    struct is_trivially_relocatable<FlatMap<K, V>>
+            : std::bool_constant<is_trivially_relocatable_v<Vector<K>> && is_trivially_relocatable_v<Vector<V>>> {};
+}
+
+// MARK: big 6 -i
+template<class K, class V>
+FlatMap<K, V>::FlatMap() : FlatMap<K, V>(defaultResource()) {}
+
+template<class K, class V>
+FlatMap<K, V>::FlatMap(MemoryResource *resource) : keys_(resource), values_(resource) {}
+
+template<class K, class V>
+FlatMap<K, V>::FlatMap(Vector<K> keys, Vector<V> values) : keys_(std::move(keys)), values_(std::move(values)) {
+    if (keys_.size() != values_.size()) {
+        throw std::invalid_argument("keys and values differ in size!");
+    }
+
+    size_type n = keys_.size();
+    if (!kstd::isSorted(keys_.begin(), keys_.end())) {
+        // the pairs are sorted through their indices, equal keys keep their order
+        Vector<size_type> order(n, keys_.resource());
+        for (size_type i = 0; i < n; ++i) {
+            order.pushBack(i);
+        }
+        kstd::sort(order.begin(), order.end(), [this](size_type lhs, size_type rhs) {
+            return keys_[lhs] < keys_[rhs] || (!(keys_[rhs] < keys_[lhs]) && lhs < rhs);
+        });
+
+        Vector<K> sortedKeys(n, keys_.resource());
+        Vector<V> sortedValues(n, values_.resource());
+        for (size_type idx: order) {
+            sortedKeys.pushBack(std::move(keys_[idx]));
+            sortedValues.pushBack(std::move(values_[idx]));
+        }
+        keys_ = std::move(sortedKeys);
+        values_ = std::move(sortedValues);
+    }
+
+    size_type kept = 0;
+    for (size_type i = 0; i < n; ++i) {
+        if (kept > 0 && !(keys_[kept - 1] < keys_[i])) {
+            continue;
+        }
+        if (kept != i) {
+            keys_[kept] = std::move(keys_[i]);
+            values_[kept] = std::move(values_[i]);
+        }
+        ++kept;
+    }
+    keys_.erase(keys_.cbegin() + kept, keys_.cend());
+    values_.erase(values_.cbegin() + kept, values_.cend());
+}
+
+template<class K, class V>
+FlatMap<K, V>::FlatMap(const FlatMap<K, V> &other, MemoryResource *resource)
+        : keys_(other.keys_, resource), values_(other.values_, resource) {}
+
+template<class K, class V>
+MemoryResource *FlatMap<K, V>::resource() const noexcept {
+    return keys_.resource();
+}
+
+// MARK: element access -i
+template<class K, class V>
+V &FlatMap<K, V>::at(const K &key) {
+    size_type idx = indexOf(key);
+    if (idx == size()) {
+        throw std::out_of_range("key is not in the map!");
+    }
+    return values_[idx];
+}
+
+template<class K, class V>
+const V &FlatMap<K, V>::at(const K &key) const {
+    size_type idx = indexOf(key);
+    if (idx == size()) {
+        throw std::out_of_range("key is not in the map!");
+    }
+    return values_[idx];
+}
+
+template<class K, class V>
+V &FlatMap<K, V>::operator[](const K &key) {
+    size_type pos = position(key);
+    if (!matches(pos, key)) {
+        emplaceAt(pos, key);
+    }
+    return values_[pos];
+}
+
+template<class K, class V>
+V &FlatMap<K, V>::operator[](K &&key) {
+    size_type pos = position(key);
+    if (!matches(pos, key)) {
+        emplaceAt(pos, std::move(key));
+    }
+    return values_[pos];
+}
+
+template<class K, class V>
+Span<const K> FlatMap<K, V>::keys() const noexcept {
+    return Span<const K>(keys_.data(), keys_.size());
+}
+
+template<class K, class V>
+Span<const V> FlatMap<K, V>::values() const noexcept {
+    return Span<const V>(values_.data(), values_.size());
+}
+
+template<class K, class V>
+Span<V> FlatMap<K, V>::values() noexcept {
+    return Span<V>(values_.data(), values_.size());
+}
+
+// MARK: capacity -i
+template<class K, class V>
+bool FlatMap<K, V>::empty() const noexcept {
+    return keys_.empty();
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::size_type FlatMap<K, V>::size() const noexcept {
+    return keys_.size();
+}
+
+template<class K, class V>
+void FlatMap<K, V>::reserve(size_type capacity) {
+    keys_.reserve(capacity);
+    values_.reserve(capacity);
+}
+
+// MARK: modifiers -i
+template<class K, class V>
+void FlatMap<K, V>::clear() noexcept {
+    keys_.clear();
+    values_.clear();
+}
+
+template<class K, class V>
+template<class M>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::insertOrAssign(const K &key, M &&value) {
+    return assign(key, std::forward<M>(value));
+}
+
+template<class K, class V>
+template<class M>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::insertOrAssign(K &&key, M &&value) {
+    return assign(std::move(key), std::forward<M>(value));
+}
+
+template<class K, class V>
+template<class... Args>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::tryEmplace(const K &key, Args &&... args) {
+    return emplaceMissing(key, std::forward<Args>(args)...);
+}
+
+template<class K, class V>
+template<class... Args>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::tryEmplace(K &&key, Args &&... args) {
+    return emplaceMissing(std::move(key), std::forward<Args>(args)...);
+}
+
+template<class K, class V>
+void FlatMap<K, V>::remove(const K &key) {
+    size_type idx = indexOf(key);
+    if (idx != size()) {
+        keys_.erase(keys_.cbegin() + idx);
+        values_.erase(values_.cbegin() + idx);
+    }
+}
+
+// MARK: lookup -i
+template<class K, class V>
+bool FlatMap<K, V>::contains(const K &key) const {
+    return indexOf(key) != size();
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::find(const K &key) {
+    return iteratorAt(indexOf(key));
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::find(const K &key) const {
+    return iteratorAt(indexOf(key));
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::lowerBound(const K &key) {
+    return iteratorAt(position(key));
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::lowerBound(const K &key) const {
+    return iteratorAt(position(key));
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::upperBound(const K &key) {
+    size_type pos = position(key);
+    return iteratorAt(matches(pos, key) ? pos + 1 : pos);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::upperBound(const K &key) const {
+    size_type pos = position(key);
+    return iteratorAt(matches(pos, key) ? pos + 1 : pos);
+}
+
+// MARK: iterators -i
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::begin() noexcept {
+    return iteratorAt(0);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::begin() const noexcept {
+    return iteratorAt(0);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::cbegin() const noexcept {
+    return iteratorAt(0);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::end() noexcept {
+    return iteratorAt(size());
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::end() const noexcept {
+    return iteratorAt(size());
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::cend() const noexcept {
+    return iteratorAt(size());
+}
+
+// MARK: helpers -i
+template<class K, class V>
+typename FlatMap<K, V>::size_type FlatMap<K, V>::position(const K &key) const {
+    return kstd::lowerBound(keys_.data(), keys_.size(), key);
+}
+
+template<class K, class V>
+bool FlatMap<K, V>::matches(size_type pos, const K &key) const {
+    return pos < size() && !(key < keys_[pos]);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::size_type FlatMap<K, V>::indexOf(const K &key) const {
+    size_type pos = position(key);
+    return matches(pos, key) ? pos : size();
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::iterator FlatMap<K, V>::iteratorAt(size_type pos) noexcept {
+    return iterator(keys_.data() + pos, values_.data() + pos);
+}
+
+template<class K, class V>
+typename FlatMap<K, V>::const_iterator FlatMap<K, V>::iteratorAt(size_type pos) const noexcept {
+    return const_iterator(keys_.data() + pos, values_.data() + pos);
+}
+
+template<class K, class V>
+template<class KK, class... Args>
+void FlatMap<K, V>::emplaceAt(size_type pos, KK &&key, Args &&... args) {
+    // the value goes in first, so a throwing key insert can be undone
+    values_.insert(values_.cbegin() + pos, V(std::forward<Args>(args)...));
+    try {
+        keys_.insert(keys_.cbegin() + pos, std::forward<KK>(key));
+    } catch (...) {
+        values_.erase(values_.cbegin() + pos);
+        throw;
+    }
+}
+
+template<class K, class V>
+template<class KK, class M>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::assign(KK &&key, M &&value) {
+    size_type pos = position(key);
+    if (matches(pos, key)) {
+        values_[pos] = std::forward<M>(value);
+        return Pair<iterator, bool>(iteratorAt(pos), false);
+    }
+    emplaceAt(pos, std::forward<KK>(key), std::forward<M>(value));
+    return Pair<iterator, bool>(iteratorAt(pos), true);
+}
+
+template<class K, class V>
+template<class KK, class... Args>
+Pair<typename FlatMap<K, V>::iterator, bool> FlatMap<K, V>::emplaceMissing(KK &&key, Args &&... args) {
+    size_type pos = position(key);
+    if (matches(pos, key)) {
+        return Pair<iterator, bool>(iteratorAt(pos), false);
+    }
+    emplaceAt(pos, std::forward<KK>(key), std::forward<Args>(args)...);
+    return Pair<iterator, bool>(iteratorAt(pos), true);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * growth policies for the buffers of Vector and Queue
+ *
+ * a growth strategy answers how big the buffer becomes when it is full:
+ *     static size_t grow(size_t capacity, size_t required, size_t elementSize)
+ * returns a capacity that is at least required
+ *
+ * a shrink strategy answers what happens after an element is removed:
+ *     static size_t shrink(size_t capacity, size_t size)
+ * returns the new capacity, returning capacity itself keeps the buffer
+ *
+ * GrowthPolicy glues one of each together
+ */
+struct DoublingGrowth {
+    static size_t grow(size_t capacity, size_t required, size_t) {
+        size_t next = 2 * capacity;
+        return next < required ? required : next;
+    }
+};
+
+struct HalfGrowth {
+    static size_t grow(size_t capacity, size_t required, size_t) {
+        size_t next = capacity + capacity / 2;
+        return next < required ? required : next;
+    }
+};
+
+// doubles and then rounds the buffer up to whole pages,
+// so the tail of the last page is not wasted
+template<size_t PageSize = 4096>
+struct PageGrowth {
+    static size_t grow(size_t capacity, size_t required, size_t elementSize) {
+        size_t bytes = DoublingGrowth::grow(capacity, required, elementSize) * elementSize;
+        bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+        return bytes / elementSize;
+    }
+};
+
+// shrinks to twice the size only when the buffer is Threshold times
+// bigger than its content, a buffer that just shrank has to lose half of
+// its elements again or fill up completely before it is reallocated,
+// so workloads oscillating around a boundary do not reallocate every time
+template<size_t Threshold = 4, size_t MinCapacity = 16>
+struct HysteresisShrink {
+    static_assert(Threshold > 2, "the threshold must leave room between shrinking and growing");
+
+    static size_t shrink(size_t capacity, size_t size) {
+        if (capacity <= MinCapacity || capacity <= Threshold * size) {
+            return capacity;
+        }
+        size_t next = 2 * size;
+        return next < MinCapacity ? MinCapacity : next;
+    }
+};
+
+struct NeverShrink {
+    static size_t shrink(size_t capacity, size_t) {
+        return capacity;
+    }
+};
+
+template<class Growth = DoublingGrowth, class Shrink = HysteresisShrink<>>
+struct GrowthPolicy : Growth, Shrink {
+    using Growth::grow;
+    using Shrink::shrink;
+};
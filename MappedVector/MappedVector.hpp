@@ -0,0 +1,444 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../ArrayIterator/ArrayIterator.hpp"
+
+/*
+ * vector whose elements live in a memory mapped file
+ *
+ * the file starts with a small header (magic, element size, size, capacity)
+ * followed by the raw elements, reopening the file maps it back
+ * without reading or converting anything, pages are loaded lazily on first touch
+ *
+ * growing extends the file with ftruncate and the mapping with mremap,
+ * so all pointers and iterators are invalidated like in Vector
+ *
+ * the elements must be trivially copyable, as they are stored byte for byte,
+ * and the file is only portable between machines with the same layout of T
+ *
+ * changes reach the file whenever the kernel writes the pages back,
+ * sync() forces it
+ *
+ * a moved-from vector owns no file, it reads as empty with no capacity
+ * and throws std::runtime_error when asked to grow
+ */
+template<class T>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be stored in a file");
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef ArrayIterator<value_type> iterator;
+    typedef ArrayIterator<const value_type> const_iterator;
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint64_t elementSize;
+        uint64_t size;
+        uint64_t capacity;
+    };
+
+    static const uint64_t MAGIC = 0x4b56454354303031; // "KVECT001"
+    static const size_type HEADER_SIZE = 64;
+    static const size_type INITIAL_CAPACITY = 1024;
+
+    static_assert(sizeof(Header) <= HEADER_SIZE && alignof(T) <= HEADER_SIZE, "the elements must fit after the header");
+
+    int fd;
+    char *mapping;
+    size_type mappedBytes;
+
+public:
+    // opens the file at path or creates it when it does not exist
+    explicit MappedVector(const char *path);
+
+    MappedVector(const MappedVector<T> &other) = delete;
+
+    MappedVector<T> &operator=(const MappedVector<T> &other) = delete;
+
+    MappedVector(MappedVector<T> &&other) noexcept;
+
+    MappedVector<T> &operator=(MappedVector<T> &&other) noexcept;
+
+    ~MappedVector();
+
+    // MARK: element access -d
+    const_reference at(size_type idx) const;
+
+    reference at(size_type idx);
+
+    const_reference operator[](size_type idx) const;
+
+    reference operator[](size_type idx);
+
+    const_reference front() const;
+
+    reference front();
+
+    const_reference back() const;
+
+    reference back();
+
+    const_pointer data() const noexcept;
+
+    pointer data() noexcept;
+
+    // MARK: iterators -d
+    const_iterator begin() const noexcept;
+
+    iterator begin() noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator cend() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    void reserve(size_type capacity);
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    void pushBack(const T &value);
+
+    void popBack();
+
+    // MARK: persistence -d
+    void sync();
+
+private:
+    void close() noexcept;
+
+    void moveFrom(MappedVector<T> &&other);
+
+    // only valid while mapping is not null
+    Header &header() const noexcept;
+
+    void remap(size_type capacity);
+
+    static size_type bytesFor(size_type capacity);
+
+    [[noreturn]] void failOpening(const char *what);
+
+    [[noreturn]] static void fail(const char *what);
+};
+
+template<class T>
+MappedVector<T>::MappedVector(const char *path) : fd{-1}, mapping{nullptr}, mappedBytes{0} {
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        failOpening("cannot open mapped vector file");
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        failOpening("cannot stat mapped vector file");
+    }
+
+    // only a file created just now gets a fresh header, anything else must already be a mapped vector
+    bool created = info.st_size == 0;
+    if (created) {
+        if (::ftruncate(fd, bytesFor(INITIAL_CAPACITY)) != 0) {
+            failOpening("cannot extend mapped vector file");
+        }
+        info.st_size = bytesFor(INITIAL_CAPACITY);
+    } else if ((size_type) info.st_size < HEADER_SIZE) {
+        close();
+        throw std::runtime_error("mapped vector file is too small");
+    }
+
+    mappedBytes = info.st_size;
+    void *memory = ::mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        mapping = nullptr;
+        failOpening("cannot map mapped vector file");
+    }
+    mapping = static_cast<char *>(memory);
+
+    Header &h = header();
+    if (created) {
+        h = Header{MAGIC, sizeof(T), 0, INITIAL_CAPACITY};
+    } else if (h.magic != MAGIC || h.elementSize != sizeof(T) || h.size > h.capacity ||
+               bytesFor(h.capacity) > mappedBytes) {
+        close();
+        throw std::runtime_error("file does not hold a mapped vector of this type");
+    }
+}
+
+template<class T>
+MappedVector<T>::MappedVector(MappedVector<T> &&other) noexcept {
+    moveFrom(std::move(other));
+}
+
+template<class T>
+MappedVector<T> &MappedVector<T>::operator=(MappedVector<T> &&other) noexcept {
+    if (this != &other) {
+        close();
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T>
+MappedVector<T>::~MappedVector() {
+    close();
+}
+
+// MARK: element access -i
+template<class T>
+typename MappedVector<T>::const_reference MappedVector<T>::at(size_type idx) const {
+    if (idx >= size()) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return data()[idx];
+}
+
+template<class T>
+typename MappedVector<T>::reference MappedVector<T>::at(size_type idx) {
+    if (idx >= size()) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return data()[idx];
+}
+
+template<class T>
+typename MappedVector<T>::const_reference MappedVector<T>::operator[](size_type idx) const {
+    return data()[idx];
+}
+
+template<class T>
+typename MappedVector<T>::reference MappedVector<T>::operator[](size_type idx) {
+    return data()[idx];
+}
+
+template<class T>
+typename MappedVector<T>::const_reference MappedVector<T>::front() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data()[0];
+}
+
+template<class T>
+typename MappedVector<T>::reference MappedVector<T>::front() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data()[0];
+}
+
+template<class T>
+typename MappedVector<T>::const_reference MappedVector<T>::back() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data()[size() - 1];
+}
+
+template<class T>
+typename MappedVector<T>::reference MappedVector<T>::back() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data()[size() - 1];
+}
+
+template<class T>
+typename MappedVector<T>::const_pointer MappedVector<T>::data() const noexcept {
+    return mapping ? reinterpret_cast<const_pointer>(mapping + HEADER_SIZE) : nullptr;
+}
+
+template<class T>
+typename MappedVector<T>::pointer MappedVector<T>::data() noexcept {
+    return mapping ? reinterpret_cast<pointer>(mapping + HEADER_SIZE) : nullptr;
+}
+
+// MARK: iterators -i
+template<class T>
+typename MappedVector<T>::const_iterator MappedVector<T>::begin() const noexcept {
+    return const_iterator(data());
+}
+
+template<class T>
+typename MappedVector<T>::iterator MappedVector<T>::begin() noexcept {
+    return iterator(data());
+}
+
+template<class T>
+typename MappedVector<T>::const_iterator MappedVector<T>::cbegin() const noexcept {
+    return const_iterator(data());
+}
+
+template<class T>
+typename MappedVector<T>::const_iterator MappedVector<T>::end() const noexcept {
+    return const_iterator(data() + size());
+}
+
+template<class T>
+typename MappedVector<T>::iterator MappedVector<T>::end() noexcept {
+    return iterator(data() + size());
+}
+
+template<class T>
+typename MappedVector<T>::const_iterator MappedVector<T>::cend() const noexcept {
+    return const_iterator(data() + size());
+}
+
+// MARK: capacity -i
+template<class T>
+bool MappedVector<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<class T>
+typename MappedVector<T>::size_type MappedVector<T>::size() const noexcept {
+    return mapping ? header().size : 0;
+}
+
+template<class T>
+typename MappedVector<T>::size_type MappedVector<T>::capacity() const noexcept {
+    return mapping ? header().capacity : 0;
+}
+
+template<class T>
+void MappedVector<T>::reserve(size_type capacity) {
+    if (capacity > this->capacity()) {
+        remap(capacity);
+    }
+}
+
+// MARK: modifiers -i
+template<class T>
+void MappedVector<T>::clear() noexcept {
+    if (mapping) {
+        header().size = 0;
+    }
+}
+
+template<class T>
+void MappedVector<T>::pushBack(const T &value) {
+    if (size() == capacity()) {
+        // value may live inside the mapping, which can move
+        T temp(value);
+        remap(capacity() == 0 ? INITIAL_CAPACITY : 2 * capacity());
+        data()[header().size++] = temp;
+        return;
+    }
+    data()[header().size++] = value;
+}
+
+template<class T>
+void MappedVector<T>::popBack() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    header().size--;
+}
+
+// MARK: persistence -i
+template<class T>
+void MappedVector<T>::sync() {
+    if (mapping && ::msync(mapping, mappedBytes, MS_SYNC) != 0) {
+        fail("cannot sync mapped vector file");
+    }
+}
+
+// MARK: helpers -i
+template<class T>
+void MappedVector<T>::close() noexcept {
+    if (mapping) {
+        ::munmap(mapping, mappedBytes);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mappedBytes = 0;
+}
+
+template<class T>
+void MappedVector<T>::moveFrom(MappedVector<T> &&other) {
+    fd = other.fd;
+    mapping = other.mapping;
+    mappedBytes = other.mappedBytes;
+
+    other.fd = -1;
+    other.mapping = nullptr;
+    other.mappedBytes = 0;
+}
+
+template<class T>
+typename MappedVector<T>::Header &MappedVector<T>::header() const noexcept {
+    return *reinterpret_cast<Header *>(mapping);
+}
+
+template<class T>
+void MappedVector<T>::remap(size_type capacity) {
+    size_type bytes = bytesFor(capacity);
+    if (::ftruncate(fd, bytes) != 0) {
+        fail("cannot extend mapped vector file");
+    }
+
+#ifdef MREMAP_MAYMOVE
+    void *memory = ::mremap(mapping, mappedBytes, bytes, MREMAP_MAYMOVE);
+    if (memory == MAP_FAILED) {
+        fail("cannot remap mapped vector file");
+    }
+#else
+    void *memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        fail("cannot remap mapped vector file");
+    }
+    ::munmap(mapping, mappedBytes);
+#endif
+
+    mapping = static_cast<char *>(memory);
+    mappedBytes = bytes;
+    header().capacity = capacity;
+}
+
+template<class T>
+typename MappedVector<T>::size_type MappedVector<T>::bytesFor(size_type capacity) {
+    return HEADER_SIZE + capacity * sizeof(T);
+}
+
+template<class T>
+void MappedVector<T>::failOpening(const char *what) {
+    // errno has to be read before close() can overwrite it
+    std::string message = std::string(what) + ": " + std::strerror(errno);
+    close();
+    throw std::runtime_error(message);
+}
+
+template<class T>
+void MappedVector<T>::fail(const char *what) {
+    throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+namespace kstd {
+    // data written by different threads is kept this far apart
+    // so that the threads do not invalidate each other's cache lines
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // the smallest power of two that is not less than n
+    constexpr size_t ceilPowerOfTwo(size_t n) noexcept {
+        size_t power = 1;
+        while (power < n) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    // asks the cache to start loading the line at address, it never faults
+    inline void prefetch(const void *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void) address;
+#endif
+    }
+
+    template<class T>
+    void destroy(T *first, T *last) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (T *it = first; it != last; ++it) {
+                it->~T();
+            }
+        }
+    }
+
+    // moves [first, last) into the uninitialised memory at dest
+    // and destroys the source, the two ranges must not overlap
+    template<class T>
+    void relocate(T *first, T *last, T *dest) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (first != last) {
+                std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                            (last - first) * sizeof(T));
+            }
+        } else {
+            for (T *it = first; it != last; ++it, ++dest) {
+                new(dest) T(std::move(*it));
+                it->~T();
+            }
+        }
+    }
+
+    // relocates [first, last) to dest for trivially relocatable types only,
+    // the ranges may overlap
+    template<class T>
+    void relocateOverlapping(T *first, T *last, T *dest) noexcept {
+        static_assert(is_trivially_relocatable_v<T>, "overlapping relocation needs a trivially relocatable type");
+        if (first != last) {
+            std::memmove(static_cast<void *>(dest), static_cast<const void *>(first),
+                         (last - first) * sizeof(T));
+        }
+    }
+
+    // copies count elements starting at first into the uninitialised memory at dest
+    // and returns the iterator past the last one copied, trivially copyable
+    // elements behind a contiguous iterator are copied with one memcpy
+    template<class InputIt, class T>
+    InputIt uninitializedCopy(InputIt first, size_t count, T *dest) {
+        if constexpr (std::is_trivially_copyable_v<T> && is_contiguous_iterator_v<InputIt>
+                      && std::is_same_v<std::remove_cv_t<std::remove_reference_t<decltype(*first)>>, T>) {
+            if (count > 0) {
+                std::memcpy(static_cast<void *>(dest), static_cast<const void *>(&*first), count * sizeof(T));
+            }
+            return first + count;
+        } else {
+            for (size_t i = 0; i < count; ++i, ++first, ++dest) {
+                new(dest) T(*first);
+            }
+            return first;
+        }
+    }
+
+    template<class T>
+    T *allocate(MemoryResource *resource, size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        return static_cast<T *>(resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template<class T>
+    void deallocate(MemoryResource *resource, T *ptr, size_t count) noexcept {
+        if (ptr) {
+            resource->deallocate(ptr, count * sizeof(T), alignof(T));
+        }
+    }
+
+    // moves a buffer holding count live elements to one with room for capacity,
+    // trivially relocatable types go through MemoryResource::reallocate
+    // and may not move at all
+    template<class T>
+    T *reallocate(MemoryResource *resource, T *ptr, size_t count, size_t oldCapacity, size_t capacity) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (capacity == 0) {
+                deallocate(resource, ptr, oldCapacity);
+                return nullptr;
+            }
+            void *newPtr = resource->reallocate(ptr, oldCapacity * sizeof(T), capacity * sizeof(T), alignof(T));
+            return static_cast<T *>(newPtr);
+        } else {
+            T *newPtr = allocate<T>(resource, capacity);
+            relocate(ptr, ptr + count, newPtr);
+            deallocate(resource, ptr, oldCapacity);
+            return newPtr;
+        }
+    }
+}
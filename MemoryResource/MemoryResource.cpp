@@ -0,0 +1,325 @@
+#include "MemoryResource.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+    class MallocResource : public MemoryResource {
+    protected:
+        // over-aligned blocks come from aligned_alloc, so every block is freed with free
+        void *doAllocate(size_t bytes, size_t alignment) override {
+            void *ptr = alignment > MAX_ALIGN
+                        ? std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment)
+                        : std::malloc(bytes);
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+
+        void doDeallocate(void *ptr, size_t, size_t) override {
+            std::free(ptr);
+        }
+
+        void *doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) override {
+            if (alignment > MAX_ALIGN) {
+                // realloc only keeps the fundamental alignment
+                void *newPtr = doAllocate(newBytes, alignment);
+                std::memcpy(newPtr, ptr, oldBytes < newBytes ? oldBytes : newBytes);
+                std::free(ptr);
+                return newPtr;
+            }
+            void *newPtr = std::realloc(ptr, newBytes);
+            if (!newPtr) {
+                throw std::bad_alloc();
+            }
+            return newPtr;
+        }
+    };
+
+    class NullResource : public MemoryResource {
+    protected:
+        void *doAllocate(size_t, size_t) override {
+            throw std::bad_alloc();
+        }
+
+        void doDeallocate(void *, size_t, size_t) override {}
+    };
+
+    // constant initialised, so containers built by other static initialisers see it,
+    // nullptr stands for mallocResource()
+    std::atomic<MemoryResource *> defaultMemoryResource{nullptr};
+
+    const size_t CHUNK_HEADER_SIZE = 2 * MemoryResource::MAX_ALIGN;
+
+    char *alignUp(char *ptr, size_t alignment) {
+        auto address = reinterpret_cast<uintptr_t>(ptr);
+        return ptr + ((alignment - address % alignment) % alignment);
+    }
+}
+
+// MARK: MemoryResource
+void *MemoryResource::allocate(size_t bytes, size_t alignment) {
+    return doAllocate(bytes, alignment);
+}
+
+void MemoryResource::deallocate(void *ptr, size_t bytes, size_t alignment) {
+    doDeallocate(ptr, bytes, alignment);
+}
+
+void *MemoryResource::reallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) {
+    if (!ptr) {
+        return doAllocate(newBytes, alignment);
+    }
+    return doReallocate(ptr, oldBytes, newBytes, alignment);
+}
+
+bool MemoryResource::isEqual(const MemoryResource &other) const noexcept {
+    return doIsEqual(other);
+}
+
+void *MemoryResource::doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) {
+    void *newPtr = doAllocate(newBytes, alignment);
+    std::memcpy(newPtr, ptr, oldBytes < newBytes ? oldBytes : newBytes);
+    doDeallocate(ptr, oldBytes, alignment);
+    return newPtr;
+}
+
+bool MemoryResource::doIsEqual(const MemoryResource &other) const noexcept {
+    return this == &other;
+}
+
+bool operator==(const MemoryResource &lhs, const MemoryResource &rhs) {
+    return &lhs == &rhs || lhs.isEqual(rhs);
+}
+
+bool operator!=(const MemoryResource &lhs, const MemoryResource &rhs) {
+    return !(lhs == rhs);
+}
+
+MemoryResource *mallocResource() noexcept {
+    static MallocResource resource;
+    return &resource;
+}
+
+MemoryResource *nullResource() noexcept {
+    static NullResource resource;
+    return &resource;
+}
+
+MemoryResource *defaultResource() noexcept {
+    MemoryResource *resource = defaultMemoryResource.load(std::memory_order_acquire);
+    return resource ? resource : mallocResource();
+}
+
+MemoryResource *setDefaultResource(MemoryResource *resource) noexcept {
+    if (resource == mallocResource()) {
+        resource = nullptr;
+    }
+    MemoryResource *previous = defaultMemoryResource.exchange(resource, std::memory_order_acq_rel);
+    return previous ? previous : mallocResource();
+}
+
+// MARK: MonotonicResource
+MonotonicResource::MonotonicResource(MemoryResource *upstream)
+        : MonotonicResource(nullptr, 0, upstream) {}
+
+MonotonicResource::MonotonicResource(size_t initialSize, MemoryResource *upstream)
+        : MonotonicResource(nullptr, 0, upstream) {
+    // a zero sized first chunk would never grow in addChunk
+    nextChunkSize = initialSize > INITIAL_CHUNK_SIZE ? initialSize : INITIAL_CHUNK_SIZE;
+}
+
+MonotonicResource::MonotonicResource(void *buffer, size_t size, MemoryResource *upstream)
+        : upstream{upstream}, chunks{nullptr},
+          initialBuffer{static_cast<char *>(buffer)}, initialSize{size},
+          current{initialBuffer}, left{initialSize},
+          nextChunkSize{size > INITIAL_CHUNK_SIZE ? 2 * size : INITIAL_CHUNK_SIZE},
+          lastAllocation{nullptr} {}
+
+MonotonicResource::~MonotonicResource() {
+    release();
+}
+
+void MonotonicResource::release() {
+    while (chunks) {
+        Chunk *next = chunks->next;
+        upstream->deallocate(chunks, chunks->size);
+        chunks = next;
+    }
+
+    current = initialBuffer;
+    left = initialSize;
+    lastAllocation = nullptr;
+}
+
+MemoryResource *MonotonicResource::upstreamResource() const {
+    return upstream;
+}
+
+void *MonotonicResource::doAllocate(size_t bytes, size_t alignment) {
+    char *aligned = alignUp(current, alignment);
+    size_t padding = aligned - current;
+
+    if (!current || padding + bytes > left) {
+        addChunk(bytes + alignment);
+        aligned = alignUp(current, alignment);
+        padding = aligned - current;
+    }
+
+    current = aligned + bytes;
+    left -= padding + bytes;
+    lastAllocation = aligned;
+    return aligned;
+}
+
+void MonotonicResource::doDeallocate(void *, size_t, size_t) {}
+
+void *MonotonicResource::doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) {
+    // the most recent allocation ends at current, so it can be resized in place
+    if (ptr == lastAllocation && (newBytes <= oldBytes || newBytes - oldBytes <= left)) {
+        left = left + oldBytes - newBytes;
+        current = lastAllocation + newBytes;
+        return ptr;
+    }
+    return MemoryResource::doReallocate(ptr, oldBytes, newBytes, alignment);
+}
+
+void MonotonicResource::addChunk(size_t minBytes) {
+    size_t size = nextChunkSize;
+    while (size < minBytes + CHUNK_HEADER_SIZE) {
+        size *= 2;
+    }
+
+    auto chunk = static_cast<Chunk *>(upstream->allocate(size));
+    chunk->next = chunks;
+    chunk->size = size;
+    chunks = chunk;
+
+    current = reinterpret_cast<char *>(chunk) + CHUNK_HEADER_SIZE;
+    left = size - CHUNK_HEADER_SIZE;
+    nextChunkSize = 2 * size;
+}
+
+// MARK: AlignedResource
+AlignedResource::AlignedResource(size_t alignment, MemoryResource *upstream)
+        : upstream{upstream}, alignment{alignment} {}
+
+MemoryResource *AlignedResource::upstreamResource() const {
+    return upstream;
+}
+
+void *AlignedResource::doAllocate(size_t bytes, size_t alignment) {
+    return upstream->allocate(bytes, alignment > this->alignment ? alignment : this->alignment);
+}
+
+void AlignedResource::doDeallocate(void *ptr, size_t bytes, size_t alignment) {
+    upstream->deallocate(ptr, bytes, alignment > this->alignment ? alignment : this->alignment);
+}
+
+void *AlignedResource::doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) {
+    return upstream->reallocate(ptr, oldBytes, newBytes, alignment > this->alignment ? alignment : this->alignment);
+}
+
+bool AlignedResource::doIsEqual(const MemoryResource &other) const noexcept {
+    // blocks of an equal adaptor went to an equal upstream with the same alignment
+    auto aligned = dynamic_cast<const AlignedResource *>(&other);
+    return aligned && alignment == aligned->alignment && *upstream == *aligned->upstream;
+}
+
+// MARK: PoolResource
+PoolResource::PoolResource(MemoryResource *upstream)
+        : upstream{upstream}, chunks{nullptr}, pools{} {
+    for (Pool &pool: pools) {
+        pool.blocksPerChunk = INITIAL_BLOCKS_PER_CHUNK;
+    }
+}
+
+PoolResource::~PoolResource() {
+    release();
+}
+
+void PoolResource::release() {
+    while (chunks) {
+        Chunk *next = chunks->next;
+        upstream->deallocate(chunks, chunks->size);
+        chunks = next;
+    }
+
+    for (Pool &pool: pools) {
+        pool.free = nullptr;
+        pool.blocksPerChunk = INITIAL_BLOCKS_PER_CHUNK;
+    }
+}
+
+MemoryResource *PoolResource::upstreamResource() const {
+    return upstream;
+}
+
+void *PoolResource::doAllocate(size_t bytes, size_t alignment) {
+    size_t idx = poolIndex(bytes, alignment);
+    if (idx == POOLS_COUNT) {
+        return upstream->allocate(bytes, alignment);
+    }
+
+    if (!pools[idx].free) {
+        refill(idx);
+    }
+
+    FreeBlock *block = pools[idx].free;
+    pools[idx].free = block->next;
+    return block;
+}
+
+void PoolResource::doDeallocate(void *ptr, size_t bytes, size_t alignment) {
+    size_t idx = poolIndex(bytes, alignment);
+    if (idx == POOLS_COUNT) {
+        upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+
+    auto block = static_cast<FreeBlock *>(ptr);
+    block->next = pools[idx].free;
+    pools[idx].free = block;
+}
+
+void PoolResource::refill(size_t pool) {
+    size_t block = blockSize(pool);
+    size_t count = pools[pool].blocksPerChunk;
+    size_t size = CHUNK_HEADER_SIZE + count * block;
+
+    auto chunk = static_cast<Chunk *>(upstream->allocate(size));
+    chunk->next = chunks;
+    chunk->size = size;
+    chunks = chunk;
+
+    char *first = reinterpret_cast<char *>(chunk) + CHUNK_HEADER_SIZE;
+    for (size_t i = count; i > 0; --i) {
+        auto freeBlock = reinterpret_cast<FreeBlock *>(first + (i - 1) * block);
+        freeBlock->next = pools[pool].free;
+        pools[pool].free = freeBlock;
+    }
+
+    if (count < MAX_BLOCKS_PER_CHUNK) {
+        pools[pool].blocksPerChunk = 2 * count;
+    }
+}
+
+size_t PoolResource::poolIndex(size_t bytes, size_t alignment) {
+    if (alignment > MAX_ALIGN || bytes > MAX_BLOCK_SIZE) {
+        return POOLS_COUNT;
+    }
+
+    size_t needed = bytes < alignment ? alignment : bytes;
+    size_t idx = 0;
+    for (size_t block = MIN_BLOCK_SIZE; block < needed; block *= 2) {
+        ++idx;
+    }
+    return idx;
+}
+
+size_t PoolResource::blockSize(size_t pool) {
+    return MIN_BLOCK_SIZE << pool;
+}
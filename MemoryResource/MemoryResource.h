@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * polymorphic memory resources, in the spirit of std::pmr
+ *
+ * every container keeps a pointer to the resource it allocates from,
+ * by default the global defaultResource() which goes to malloc
+ *
+ * the resource must outlive every container that uses it,
+ * copies of a container get the default resource
+ * while moves, move assignment included, take the resource of the source,
+ * so a move never allocates and never throws
+ */
+class MemoryResource {
+public:
+    static const size_t MAX_ALIGN = alignof(std::max_align_t);
+
+    virtual ~MemoryResource() = default;
+
+    void *allocate(size_t bytes, size_t alignment = MAX_ALIGN);
+
+    void deallocate(void *ptr, size_t bytes, size_t alignment = MAX_ALIGN);
+
+    // the first min(oldBytes, newBytes) bytes are preserved,
+    // ptr may be extended in place
+    void *reallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment = MAX_ALIGN);
+
+    bool isEqual(const MemoryResource &other) const noexcept;
+
+protected:
+    virtual void *doAllocate(size_t bytes, size_t alignment) = 0;
+
+    virtual void doDeallocate(void *ptr, size_t bytes, size_t alignment) = 0;
+
+    virtual void *doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment);
+
+    virtual bool doIsEqual(const MemoryResource &other) const noexcept;
+};
+
+bool operator==(const MemoryResource &lhs, const MemoryResource &rhs);
+
+bool operator!=(const MemoryResource &lhs, const MemoryResource &rhs);
+
+// malloc / realloc / free
+MemoryResource *mallocResource() noexcept;
+
+// throws std::bad_alloc on every allocation
+MemoryResource *nullResource() noexcept;
+
+MemoryResource *defaultResource() noexcept;
+
+// returns the previous default resource, nullptr restores mallocResource()
+MemoryResource *setDefaultResource(MemoryResource *resource) noexcept;
+
+/*
+ * arena that hands out memory by bumping a pointer
+ *
+ * deallocate does nothing, everything is given back at once by release()
+ * or by the destructor, the last allocation can be grown in place
+ *
+ * memory comes from an optional initial buffer first and then from
+ * geometrically growing chunks taken from the upstream resource
+ */
+class MonotonicResource : public MemoryResource {
+private:
+    struct Chunk {
+        Chunk *next;
+        size_t size;
+    };
+
+    static const size_t INITIAL_CHUNK_SIZE = 1024;
+
+    MemoryResource *upstream;
+    Chunk *chunks;
+
+    char *initialBuffer;
+    size_t initialSize;
+
+    char *current;
+    size_t left;
+    size_t nextChunkSize;
+
+    char *lastAllocation;
+
+public:
+    explicit MonotonicResource(MemoryResource *upstream = defaultResource());
+
+    explicit MonotonicResource(size_t initialSize, MemoryResource *upstream = defaultResource());
+
+    MonotonicResource(void *buffer, size_t size, MemoryResource *upstream = defaultResource());
+
+    MonotonicResource(const MonotonicResource &other) = delete;
+
+    MonotonicResource &operator=(const MonotonicResource &other) = delete;
+
+    ~MonotonicResource() override;
+
+    void release();
+
+    MemoryResource *upstreamResource() const;
+
+protected:
+    void *doAllocate(size_t bytes, size_t alignment) override;
+
+    void doDeallocate(void *ptr, size_t bytes, size_t alignment) override;
+
+    void *doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) override;
+
+private:
+    void addChunk(size_t minBytes);
+};
+
+/*
+ * raises the alignment of every request to at least alignment
+ * and passes it on to the upstream resource, e.g. for arrays that
+ * are read a cache line at a time
+ */
+class AlignedResource : public MemoryResource {
+private:
+    MemoryResource *upstream;
+    size_t alignment;
+
+public:
+    explicit AlignedResource(size_t alignment, MemoryResource *upstream = defaultResource());
+
+    MemoryResource *upstreamResource() const;
+
+protected:
+    void *doAllocate(size_t bytes, size_t alignment) override;
+
+    void doDeallocate(void *ptr, size_t bytes, size_t alignment) override;
+
+    void *doReallocate(void *ptr, size_t oldBytes, size_t newBytes, size_t alignment) override;
+
+    bool doIsEqual(const MemoryResource &other) const noexcept override;
+};
+
+/*
+ * pools of fixed size blocks, one per power of two up to MAX_BLOCK_SIZE
+ *
+ * freed blocks go to the free list of their pool and are reused,
+ * bigger or over-aligned requests go straight to the upstream resource
+ *
+ * not thread safe, use one pool per thread
+ */
+class PoolResource : public MemoryResource {
+public:
+    static const size_t MIN_BLOCK_SIZE = sizeof(void *);
+    static const size_t MAX_BLOCK_SIZE = 4096;
+    static const size_t POOLS_COUNT = 10;
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct Chunk {
+        Chunk *next;
+        size_t size;
+    };
+
+    struct Pool {
+        FreeBlock *free;
+        size_t blocksPerChunk;
+    };
+
+    static const size_t INITIAL_BLOCKS_PER_CHUNK = 16;
+    static const size_t MAX_BLOCKS_PER_CHUNK = 1024;
+
+    MemoryResource *upstream;
+    Chunk *chunks;
+    Pool pools[POOLS_COUNT];
+
+public:
+    explicit PoolResource(MemoryResource *upstream = defaultResource());
+
+    PoolResource(const PoolResource &other) = delete;
+
+    PoolResource &operator=(const PoolResource &other) = delete;
+
+    ~PoolResource() override;
+
+    void release();
+
+    MemoryResource *upstreamResource() const;
+
+protected:
+    void *doAllocate(size_t bytes, size_t alignment) override;
+
+    void doDeallocate(void *ptr, size_t bytes, size_t alignment) override;
+
+private:
+    void refill(size_t pool);
+
+    static size_t poolIndex(size_t bytes, size_t alignment);
+
+    static size_t blockSize(size_t pool);
+};
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+/*
+ * bounded lock-free queue for any number of producers and consumers
+ *
+ * the ring of Queue with a power-of-two capacity, every slot carries a sequence number
+ * (D. Vyukov's bounded mpmc queue):
+ *   sequence == pos             the slot is free for the producer that claims pos
+ *   sequence == pos + 1         the slot holds the element for the consumer that claims pos
+ *   sequence == pos + capacity  the slot is free again for the next lap
+ *
+ * a thread claims a position with one compare and swap on put or get
+ * and then owns the slot, threads only contend on the index they share
+ *
+ * the batch operations claim several consecutive positions with a single compare and swap
+ */
+template<class T>
+class MpmcQueue {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *element() noexcept {
+            return reinterpret_cast<T *>(storage);
+        }
+    };
+
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<size_t> put;
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<size_t> get;
+    alignas(kstd::CACHE_LINE_SIZE) Slot *slots;
+    size_t mask;
+    MemoryResource *resource_;
+
+    // busy waits before the blocking operations start yielding
+    static const unsigned SPIN_LIMIT = 64;
+
+public:
+    explicit MpmcQueue(size_t capacity, MemoryResource *resource = defaultResource());
+
+    MpmcQueue(const MpmcQueue<T> &other) = delete;
+
+    MpmcQueue<T> &operator=(const MpmcQueue<T> &other) = delete;
+
+    ~MpmcQueue();
+
+    // MARK: non-blocking -d
+    bool tryPush(const T &element);
+
+    bool tryPush(T &&element);
+
+    template<class... Args>
+    bool tryEmplace(Args &&... args);
+
+    bool tryPop(T &element);
+
+    // MARK: blocking -d
+    // spins and then yields until there is room / an element
+    void push(const T &element);
+
+    void push(T &&element);
+
+    void pop(T &element);
+
+    // MARK: batch -d
+    // moves up to last - first elements from [first, last) into the queue
+    // and returns how many were pushed
+    template<class ForwardIt>
+    size_t tryPushBulk(ForwardIt first, ForwardIt last);
+
+    // moves up to max elements to out and returns how many were popped
+    template<class OutputIt>
+    size_t tryPopBulk(OutputIt out, size_t max);
+
+    // MARK: capacity -d
+    // exact only when no thread is running
+    bool empty() const noexcept;
+
+    size_t size() const noexcept;
+
+    size_t capacity() const noexcept;
+
+    MemoryResource *resource() const noexcept;
+
+private:
+    // claims up to max consecutive positions of index whose slots are ready,
+    // lap is 0 for producers and 1 for consumers, returns the first position
+    size_t claim(std::atomic<size_t> &index, size_t lap, size_t &max);
+
+    static void backoff(unsigned &spins);
+};
+
+template<class T>
+MpmcQueue<T>::MpmcQueue(size_t capacity, MemoryResource *resource)
+        : put{0}, get{0}, resource_{resource} {
+    if (capacity == 0) {
+        throw std::length_error("capacity must be positive!");
+    }
+    capacity = kstd::ceilPowerOfTwo(capacity);
+    slots = kstd::allocate<Slot>(resource_, capacity);
+    mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        new(&slots[i].sequence) std::atomic<size_t>(i);
+    }
+}
+
+template<class T>
+MpmcQueue<T>::~MpmcQueue() {
+    size_t end = put.load(std::memory_order_relaxed);
+    for (size_t pos = get.load(std::memory_order_relaxed); pos != end; ++pos) {
+        slots[pos & mask].element()->~T();
+    }
+    kstd::deallocate(resource_, slots, mask + 1);
+}
+
+// MARK: non-blocking -i
+template<class T>
+bool MpmcQueue<T>::tryPush(const T &element) {
+    return tryEmplace(element);
+}
+
+template<class T>
+bool MpmcQueue<T>::tryPush(T &&element) {
+    return tryEmplace(std::move(element));
+}
+
+template<class T>
+template<class... Args>
+bool MpmcQueue<T>::tryEmplace(Args &&... args) {
+    size_t count = 1;
+    size_t pos = claim(put, 0, count);
+    if (count == 0) {
+        return false;
+    }
+
+    Slot &slot = slots[pos & mask];
+    new(slot.element()) T(std::forward<Args>(args)...);
+    slot.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T>
+bool MpmcQueue<T>::tryPop(T &element) {
+    size_t count = 1;
+    size_t pos = claim(get, 1, count);
+    if (count == 0) {
+        return false;
+    }
+
+    Slot &slot = slots[pos & mask];
+    element = std::move(*slot.element());
+    slot.element()->~T();
+    slot.sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+// MARK: blocking -i
+template<class T>
+void MpmcQueue<T>::push(const T &element) {
+    unsigned spins = 0;
+    while (!tryPush(element)) {
+        backoff(spins);
+    }
+}
+
+template<class T>
+void MpmcQueue<T>::push(T &&element) {
+    unsigned spins = 0;
+    while (!tryPush(std::move(element))) {
+        backoff(spins);
+    }
+}
+
+template<class T>
+void MpmcQueue<T>::pop(T &element) {
+    unsigned spins = 0;
+    while (!tryPop(element)) {
+        backoff(spins);
+    }
+}
+
+// MARK: batch -i
+template<class T>
+template<class ForwardIt>
+size_t MpmcQueue<T>::tryPushBulk(ForwardIt first, ForwardIt last) {
+    size_t count = 0;
+    for (ForwardIt it = first; it != last && count <= mask; ++it) {
+        ++count;
+    }
+
+    size_t pos = claim(put, 0, count);
+    for (size_t i = 0; i < count; ++i, ++first) {
+        Slot &slot = slots[(pos + i) & mask];
+        new(slot.element()) T(std::move(*first));
+        slot.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+template<class T>
+template<class OutputIt>
+size_t MpmcQueue<T>::tryPopBulk(OutputIt out, size_t max) {
+    size_t count = max <= mask ? max : mask + 1;
+
+    size_t pos = claim(get, 1, count);
+    for (size_t i = 0; i < count; ++i, ++out) {
+        Slot &slot = slots[(pos + i) & mask];
+        *out = std::move(*slot.element());
+        slot.element()->~T();
+        slot.sequence.store(pos + i + mask + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+// MARK: capacity -i
+template<class T>
+bool MpmcQueue<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<class T>
+size_t MpmcQueue<T>::size() const noexcept {
+    size_t begin = get.load(std::memory_order_acquire);
+    size_t end = put.load(std::memory_order_acquire);
+    return end > begin ? end - begin : 0;
+}
+
+template<class T>
+size_t MpmcQueue<T>::capacity() const noexcept {
+    return mask + 1;
+}
+
+template<class T>
+MemoryResource *MpmcQueue<T>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: helpers -i
+template<class T>
+size_t MpmcQueue<T>::claim(std::atomic<size_t> &index, size_t lap, size_t &max) {
+    size_t pos = index.load(std::memory_order_relaxed);
+    while (max > 0) {
+        // the slots of one claim are owned only after the compare and swap succeeds,
+        // so checking them one by one beforehand is safe
+        size_t ready = 0;
+        for (; ready < max; ++ready) {
+            size_t sequence = slots[(pos + ready) & mask].sequence.load(std::memory_order_acquire);
+            if (sequence != pos + ready + lap) {
+                break;
+            }
+        }
+
+        if (ready == 0) {
+            size_t sequence = slots[pos & mask].sequence.load(std::memory_order_acquire);
+            if ((ptrdiff_t) (sequence - (pos + lap)) < 0) {
+                // full for producers, empty for consumers
+                max = 0;
+                return pos;
+            }
+            // another thread took pos in the meantime
+            pos = index.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (index.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+            max = ready;
+            return pos;
+        }
+    }
+    return pos;
+}
+
+template<class T>
+void MpmcQueue<T>::backoff(unsigned &spins) {
+    if (spins < SPIN_LIMIT) {
+        ++spins;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
@@ -1,8 +1,59 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include "../Pair/Pair.hpp"
 #include "../Vector/Vector.hpp"
+#include "../Memory/Memory.hpp"
+#include "../Simd/Simd.h"
 #include "../Algorithm/Algorithm.hpp"
 
+template<class T>
+class OrderedSet;
+
+namespace kstd {
+    template<class T>
+    OrderedSet<T> unite(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    template<class T>
+    OrderedSet<T> intersect(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    template<class T>
+    OrderedSet<T> subtract(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    template<class T>
+    OrderedSet<T> symmetricDifference(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+}
+
+/*
+ * sorted Vector with binary search
+ *
+ * useLookupLayout() keeps a second copy of the elements in Eytzinger (BFS) order
+ * the descent through it is branchless, the copy is 1-based and cache line aligned,
+ * so the descendants of a node a few levels down fill exactly one cache line
+ * that is prefetched while the levels above are compared, which suits sets that are read
+ * far more often than written
+ * mutations only mark the copy stale and the next lookup rebuilds it
+ *
+ * for 32 and 64 bit integers the binary search stops at a block of two cache lines
+ * and finishes with vector compares, see Simd.h
+ *
+ * the set operations are one merge of the two sorted vectors, when one set is more than
+ * GALLOP_RATIO times larger the merge skips through it with exponential search,
+ * the kstd functions build a new set and the members change this one in its own storage
+ *
+ * useInsertBuffer() makes add append to a small unsorted buffer instead of shifting the vector,
+ * a full buffer is sorted and merged in one pass, contains and remove check both parts
+ * and everything that needs the order (iteration, find, rank ...) merges the buffer first
+ * with a buffer of B elements an add costs O(B) for the duplicate scan plus an amortised
+ * O(n / B) share of the merge, about O(sqrt n) for B near sqrt n, not O(log n)
+ *
+ * const members may be called from many threads at once, the merge and the layout rebuild
+ * they trigger run under a lock and are published through atomic flags,
+ * while the buffer holds elements contains and size take that lock too
+ */
 template<class T>
 class OrderedSet {
 public:
@@ -12,14 +63,44 @@ public:
     typedef typename Vector<T>::difference_type difference_type;
     typedef typename Vector<T>::const_iterator const_iterator;
 private:
-    Vector<T> elements;
+    static constexpr size_type NPOS = size_type(-1);
+    static constexpr size_type GALLOP_RATIO = 8;
+    // descendants of a node that share one cache line, at least the four grandchildren
+    static constexpr size_type PREFETCH_SPAN =
+            sizeof(T) * 4 > kstd::CACHE_LINE_SIZE ? 4 : kstd::ceilPowerOfTwo(kstd::CACHE_LINE_SIZE / sizeof(T) + 1) / 2;
+
+    static constexpr size_type LAZY_MUTEXES = 16;
+
+    mutable Vector<T> elements;
+    // unsorted elements that are in neither elements nor earlier in the buffer
+    mutable Vector<T> pending;
+    // set when add fills pending, cleared under lazyMutex() once it is merged
+    mutable std::atomic<bool> buffered;
+    size_type bufferCapacity;
+
+    bool lookupLayout;
+    // set by every change of elements, cleared under lazyMutex() once the layout is rebuilt
+    mutable std::atomic<bool> layoutStale;
+    // the elements in Eytzinger order and the index of each one in elements,
+    // node k is at k and slot 0 only pads the cache line aligned array
+    mutable Vector<T> layout;
+    mutable Vector<size_type> ranks;
 public:
-    OrderedSet() = default;
+    OrderedSet();
 
+    // sorts and drops the duplicates once, an already sorted input is taken in O(n)
     OrderedSet(const Vector<T> &elements);
 
     OrderedSet(Vector<T> &&elements);
 
+    OrderedSet(const OrderedSet<T> &other);
+
+    OrderedSet(OrderedSet<T> &&other) noexcept;
+
+    OrderedSet<T> &operator=(const OrderedSet<T> &other);
+
+    OrderedSet<T> &operator=(OrderedSet<T> &&other) noexcept;
+
     bool empty() const;
 
     size_type size() const;
@@ -28,10 +109,33 @@ public:
 
     void clear();
 
+    // builds the read-optimised copy and keeps it up to date from now on
+    void useLookupLayout(bool enable = true);
+
+    bool usesLookupLayout() const;
+
+    // add goes through a buffer of capacity elements, 0 merges it and turns it off
+    // about the square root of the expected size balances the buffer scans against the merges
+    void useInsertBuffer(size_type capacity = 256);
+
     void add(const T &element);
 
     void add(T &&element);
 
+    // merges a batch into the set in one linear pass instead of one insert per element
+    template<class InputIt>
+    void insertRange(InputIt first, InputIt last);
+
+    void insertRange(Vector<T> &&batch);
+
+    void unite(const OrderedSet<T> &other);
+
+    void intersect(const OrderedSet<T> &other);
+
+    void subtract(const OrderedSet<T> &other);
+
+    void symmetricDifference(const OrderedSet<T> &other);
+
     void remove(const T &element);
 
     bool contains(const T &element) const;
@@ -40,6 +144,28 @@ public:
 
     const_iterator find(const T &element) const;
 
+    // the first element not less than / greater than element
+    iterator lowerBound(const T &element);
+
+    const_iterator lowerBound(const T &element) const;
+
+    iterator upperBound(const T &element);
+
+    const_iterator upperBound(const T &element) const;
+
+    Pair<iterator, iterator> equalRange(const T &element);
+
+    Pair<const_iterator, const_iterator> equalRange(const T &element) const;
+
+    // the number of elements less than element
+    size_type rank(const T &element) const;
+
+    // the element with k smaller ones
+    const T &select(size_type k) const;
+
+    // the number of elements in [from, to)
+    size_type countInRange(const T &from, const T &to) const;
+
     iterator begin();
 
     const_iterator begin() const;
@@ -51,157 +177,809 @@ public:
     const_iterator end() const;
 
     const_iterator cend() const;
+
+private:
+    template<class U>
+    void insert(U &&element);
+
+    // merges the insert buffer into elements, safe to run from concurrent readers
+    void flush() const;
+
+    // serialises the work const members do for a shared set, a small table of
+    // mutexes picked by address keeps the set itself trivially relocatable
+    std::mutex &lazyMutex() const;
+
+    // merges a sorted batch without duplicates into target
+    static void mergeSorted(Vector<T> &target, Vector<T> &batch);
+
+    size_type position(const T &element) const;
+
+    size_type upperPosition(const T &element) const;
+
+    // index in elements of the element equal to element, NPOS if there is none
+    size_type indexOf(const T &element) const;
+
+    // rebuilds a stale layout, safe to run from concurrent readers
+    void refreshLayout() const;
+
+    void buildLayout() const;
+
+    static MemoryResource *layoutResource();
+
+    size_type fillLayout(size_type node, size_type idx) const;
+
+    // lower bound through the layout, 1-based node in layout or 0 if every element is less
+    size_type layoutLowerBound(const T &element) const;
+
+    // sorts and dedups a vector in place
+    static void normalize(Vector<T> &values);
+
+    // first index in [from, to) whose element is not less than key, probing 1, 2, 4 ... ahead
+    static size_type gallop(const Vector<T> &values, size_type from, size_type to, const T &key);
+
+    /*
+     * walks a and b in order and hands every index that belongs in the result
+     * to emitA or emitB, an element in both sets goes to emitA
+     */
+    template<class EmitA, class EmitB>
+    static void merge(const Vector<T> &a, const Vector<T> &b, bool keepA, bool keepB, bool keepCommon,
+                      EmitA emitA, EmitB emitB);
+
+    // keeps the elements chosen by merge, they never move past their own index
+    void compact(const OrderedSet<T> &other, bool keepA, bool keepCommon);
+
+    // makes room for the elements only other has and merges from the back
+    void mergeFromBack(const OrderedSet<T> &other, bool keepCommon);
+
+    friend OrderedSet<T> kstd::unite<T>(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    friend OrderedSet<T> kstd::intersect<T>(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    friend OrderedSet<T> kstd::subtract<T>(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
+
+    friend OrderedSet<T> kstd::symmetricDifference<T>(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs);
 };
 
+namespace kstd {
+    template<class T>
+    struct is_trivially_relocatable<OrderedSet<T>> : is_trivially_relocatable<Vector<T>> {};
+
+    template<class T>
+    OrderedSet<T> unite(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs) {
+        lhs.flush();
+        rhs.flush();
+        OrderedSet<T> result;
+        result.elements.reserve(lhs.size() + rhs.size());
+        OrderedSet<T>::merge(lhs.elements, rhs.elements, true, true, true,
+                             [&](size_t i) { result.elements.pushBack(lhs.elements[i]); },
+                             [&](size_t j) { result.elements.pushBack(rhs.elements[j]); });
+        return result;
+    }
+
+    template<class T>
+    OrderedSet<T> intersect(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs) {
+        lhs.flush();
+        rhs.flush();
+        OrderedSet<T> result;
+        result.elements.reserve(lhs.size() < rhs.size() ? lhs.size() : rhs.size());
+        OrderedSet<T>::merge(lhs.elements, rhs.elements, false, false, true,
+                             [&](size_t i) { result.elements.pushBack(lhs.elements[i]); },
+                             [](size_t) {});
+        return result;
+    }
+
+    template<class T>
+    OrderedSet<T> subtract(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs) {
+        lhs.flush();
+        rhs.flush();
+        OrderedSet<T> result;
+        result.elements.reserve(lhs.size());
+        OrderedSet<T>::merge(lhs.elements, rhs.elements, true, false, false,
+                             [&](size_t i) { result.elements.pushBack(lhs.elements[i]); },
+                             [](size_t) {});
+        return result;
+    }
+
+    template<class T>
+    OrderedSet<T> symmetricDifference(const OrderedSet<T> &lhs, const OrderedSet<T> &rhs) {
+        lhs.flush();
+        rhs.flush();
+        OrderedSet<T> result;
+        result.elements.reserve(lhs.size() + rhs.size());
+        OrderedSet<T>::merge(lhs.elements, rhs.elements, true, true, false,
+                             [&](size_t i) { result.elements.pushBack(lhs.elements[i]); },
+                             [&](size_t j) { result.elements.pushBack(rhs.elements[j]); });
+        return result;
+    }
+}
+
+template<class T>
+OrderedSet<T>::OrderedSet()
+        : buffered{false}, bufferCapacity{0}, lookupLayout{false}, layoutStale{true}, layout(layoutResource()) {}
+
 template<class T>
-OrderedSet<T>::OrderedSet(const Vector<T> &elements) {
-    for (auto &element: elements) {
-        add(element);
+OrderedSet<T>::OrderedSet(const Vector<T> &elements)
+        : elements(elements), buffered{false}, bufferCapacity{0}, lookupLayout{false}, layoutStale{true},
+          layout(layoutResource()) {
+    normalize(this->elements);
+}
+
+template<class T>
+OrderedSet<T>::OrderedSet(Vector<T> &&elements)
+        : elements(std::move(elements)), buffered{false}, bufferCapacity{0}, lookupLayout{false}, layoutStale{true},
+          layout(layoutResource()) {
+    normalize(this->elements);
+}
+
+template<class T>
+OrderedSet<T>::OrderedSet(const OrderedSet<T> &other)
+        : buffered{false}, bufferCapacity{other.bufferCapacity}, lookupLayout{other.lookupLayout}, layoutStale{true},
+          layout(layoutResource()) {
+    // the copy starts merged, its layout is built by its first lookup
+    other.flush();
+    elements = other.elements;
+    pending.reserve(bufferCapacity);
+}
+
+template<class T>
+OrderedSet<T>::OrderedSet(OrderedSet<T> &&other) noexcept
+        : elements(std::move(other.elements)), pending(std::move(other.pending)),
+          buffered{other.buffered.load(std::memory_order_relaxed)}, bufferCapacity{other.bufferCapacity},
+          lookupLayout{other.lookupLayout}, layoutStale{other.layoutStale.load(std::memory_order_relaxed)},
+          layout(std::move(other.layout)), ranks(std::move(other.ranks)) {
+    other.buffered.store(false, std::memory_order_relaxed);
+    other.layoutStale.store(true, std::memory_order_relaxed);
+}
+
+template<class T>
+OrderedSet<T> &OrderedSet<T>::operator=(const OrderedSet<T> &other) {
+    if (this != &other) {
+        other.flush();
+        elements = other.elements;
+        pending.clear();
+        buffered.store(false, std::memory_order_relaxed);
+        bufferCapacity = other.bufferCapacity;
+        lookupLayout = other.lookupLayout;
+        layoutStale.store(true, std::memory_order_relaxed);
     }
+    return *this;
 }
 
 template<class T>
-OrderedSet<T>::OrderedSet(Vector<T> &&elements) {
-    for (auto &element: elements) {
-        add(std::move(element));
+OrderedSet<T> &OrderedSet<T>::operator=(OrderedSet<T> &&other) noexcept {
+    if (this != &other) {
+        elements = std::move(other.elements);
+        pending = std::move(other.pending);
+        buffered.store(other.buffered.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bufferCapacity = other.bufferCapacity;
+        lookupLayout = other.lookupLayout;
+        layoutStale.store(other.layoutStale.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        layout = std::move(other.layout);
+        ranks = std::move(other.ranks);
+
+        other.buffered.store(false, std::memory_order_relaxed);
+        other.layoutStale.store(true, std::memory_order_relaxed);
     }
+    return *this;
 }
 
 template<class T>
 bool OrderedSet<T>::empty() const {
-    return elements.empty();
+    return size() == 0;
 }
 
 template<class T>
 typename OrderedSet<T>::size_type OrderedSet<T>::size() const {
+    if (buffered.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(lazyMutex());
+        return elements.size() + pending.size();
+    }
     return elements.size();
 }
 
 template<class T>
 typename OrderedSet<T>::size_type OrderedSet<T>::capacity() const {
+    flush();
     return elements.capacity();
 }
 
 template<class T>
 void OrderedSet<T>::clear() {
     elements.clear();
+    pending.clear();
+    buffered.store(false, std::memory_order_relaxed);
+    layoutStale.store(true, std::memory_order_relaxed);
 }
 
 template<class T>
-void OrderedSet<T>::add(const T &element) {
-    if (contains(element)) {
-        return;
+void OrderedSet<T>::useLookupLayout(bool enable) {
+    lookupLayout = enable;
+    if (enable) {
+        flush();
+        buildLayout();
+        layoutStale.store(false, std::memory_order_relaxed);
+    } else {
+        layout.clear();
+        layout.shrinkToFit();
+        ranks.clear();
+        ranks.shrinkToFit();
+        layoutStale.store(true, std::memory_order_relaxed);
     }
-    elements.pushBack(element);
-    size_type last = elements.size() - 1;
+}
 
-    while (last > 0) {
-        if (elements[last - 1] < elements[last]) {
-            break;
-        }
+template<class T>
+bool OrderedSet<T>::usesLookupLayout() const {
+    return lookupLayout;
+}
 
-        kstd::swap(elements[last], elements[last - 1]);
-        --last;
+template<class T>
+void OrderedSet<T>::useInsertBuffer(size_type capacity) {
+    bufferCapacity = capacity;
+    if (capacity == 0 || pending.size() >= capacity) {
+        flush();
     }
+    pending.reserve(capacity);
+}
+
+template<class T>
+void OrderedSet<T>::add(const T &element) {
+    insert(element);
 }
 
 template<class T>
 void OrderedSet<T>::add(T &&element) {
-    if (contains(element)) {
-        return;
+    insert(std::move(element));
+}
+
+template<class T>
+template<class InputIt>
+void OrderedSet<T>::insertRange(InputIt first, InputIt last) {
+    Vector<T> batch(elements.resource());
+    batch.assign(first, last);
+    insertRange(std::move(batch));
+}
+
+template<class T>
+void OrderedSet<T>::insertRange(Vector<T> &&batch) {
+    // the buffer is merged along with the batch
+    for (auto &element: pending) {
+        batch.pushBack(std::move(element));
+    }
+    pending.clear();
+    buffered.store(false, std::memory_order_relaxed);
+
+    normalize(batch);
+    if (!batch.empty()) {
+        mergeSorted(elements, batch);
+        layoutStale.store(true, std::memory_order_relaxed);
     }
-    elements.pushBack(std::move(element));
-    size_type last = elements.size() - 1;
+}
 
-    while (last > 0) {
-        if (elements[last - 1] < elements[last]) {
-            break;
+template<class T>
+void OrderedSet<T>::unite(const OrderedSet<T> &other) {
+    flush();
+    other.flush();
+    if (this == &other || other.empty()) {
+        return;
+    }
+    if (empty() || elements.back() < other.elements.front()) {
+        elements.reserve(size() + other.size());
+        for (auto &element: other) {
+            elements.pushBack(element);
         }
+        layoutStale.store(true, std::memory_order_relaxed);
+        return;
+    }
+    mergeFromBack(other, true);
+}
 
-        kstd::swap(elements[last], elements[last - 1]);
-        --last;
+template<class T>
+void OrderedSet<T>::intersect(const OrderedSet<T> &other) {
+    flush();
+    other.flush();
+    if (this != &other) {
+        compact(other, false, true);
     }
 }
 
 template<class T>
-void OrderedSet<T>::remove(const T &element) {
-    const_iterator pos = cbegin() + (find(element) - begin());
-    if (pos != cend()) {
-        elements.erase(pos);
+void OrderedSet<T>::subtract(const OrderedSet<T> &other) {
+    flush();
+    other.flush();
+    if (this == &other) {
+        clear();
+        return;
     }
+    compact(other, true, false);
 }
 
 template<class T>
-bool OrderedSet<T>::contains(const T &element) const {
-    return find(element) != cend();
+void OrderedSet<T>::symmetricDifference(const OrderedSet<T> &other) {
+    flush();
+    other.flush();
+    if (this == &other) {
+        clear();
+        return;
+    }
+    mergeFromBack(other, false);
 }
 
 template<class T>
-typename OrderedSet<T>::iterator OrderedSet<T>::find(const T &element) {
-    int left = 0;
-    int right = size() - 1;
+void OrderedSet<T>::remove(const T &element) {
+    for (size_type i = 0; i < pending.size(); ++i) {
+        if (pending[i] == element) {
+            if (i + 1 < pending.size()) {
+                pending[i] = std::move(pending.back());
+            }
+            pending.popBack();
+            return;
+        }
+    }
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+    size_type idx = indexOf(element);
+    if (idx != NPOS) {
+        elements.erase(elements.cbegin() + idx);
+        layoutStale.store(true, std::memory_order_relaxed);
+    }
+}
 
-        if (elements[mid] == element) {
-            return iterator(&elements[mid]);
-        } else if (elements[mid] < element) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+template<class T>
+bool OrderedSet<T>::contains(const T &element) const {
+    if (buffered.load(std::memory_order_acquire)) {
+        // another reader may be merging the buffer, so both parts are searched under its lock
+        std::lock_guard<std::mutex> lock(lazyMutex());
+        if (kstd::find(pending.begin(), pending.end(), element) != pending.end()) {
+            return true;
         }
+        size_type pos = position(element);
+        return pos < elements.size() && elements[pos] == element;
     }
+    if (lookupLayout) {
+        refreshLayout();
+        size_type node = layoutLowerBound(element);
+        return node != 0 && layout[node] == element;
+    }
+    return indexOf(element) != NPOS;
+}
 
-    return end();
+template<class T>
+typename OrderedSet<T>::iterator OrderedSet<T>::find(const T &element) {
+    flush();
+    size_type idx = indexOf(element);
+    return idx != NPOS ? begin() + idx : end();
 }
 
 template<class T>
 typename OrderedSet<T>::const_iterator OrderedSet<T>::find(const T &element) const {
-    int left = 0;
-    int right = size() - 1;
+    flush();
+    size_type idx = indexOf(element);
+    return idx != NPOS ? cbegin() + idx : cend();
+}
+
+template<class T>
+typename OrderedSet<T>::iterator OrderedSet<T>::lowerBound(const T &element) {
+    flush();
+    return begin() + position(element);
+}
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+template<class T>
+typename OrderedSet<T>::const_iterator OrderedSet<T>::lowerBound(const T &element) const {
+    flush();
+    return cbegin() + position(element);
+}
 
-        if (elements[mid] == element) {
-            return const_iterator(&elements[mid]);
-        } else if (elements[mid] < element) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
+template<class T>
+typename OrderedSet<T>::iterator OrderedSet<T>::upperBound(const T &element) {
+    flush();
+    return begin() + upperPosition(element);
+}
+
+template<class T>
+typename OrderedSet<T>::const_iterator OrderedSet<T>::upperBound(const T &element) const {
+    flush();
+    return cbegin() + upperPosition(element);
+}
+
+template<class T>
+Pair<typename OrderedSet<T>::iterator, typename OrderedSet<T>::iterator>
+OrderedSet<T>::equalRange(const T &element) {
+    iterator first = lowerBound(element);
+    iterator last = first != end() && !(element < *first) ? first + 1 : first;
+    return Pair<iterator, iterator>(first, last);
+}
+
+template<class T>
+Pair<typename OrderedSet<T>::const_iterator, typename OrderedSet<T>::const_iterator>
+OrderedSet<T>::equalRange(const T &element) const {
+    const_iterator first = lowerBound(element);
+    const_iterator last = first != cend() && !(element < *first) ? first + 1 : first;
+    return Pair<const_iterator, const_iterator>(first, last);
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::rank(const T &element) const {
+    flush();
+    return position(element);
+}
+
+template<class T>
+const T &OrderedSet<T>::select(size_type k) const {
+    flush();
+    if (k >= size()) {
+        throw std::out_of_range("index is out of range!");
     }
+    return elements[k];
+}
 
-    return cend();
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::countInRange(const T &from, const T &to) const {
+    if (!(from < to)) {
+        return 0;
+    }
+    flush();
+    return position(to) - position(from);
 }
 
 template<class T>
 typename OrderedSet<T>::iterator OrderedSet<T>::begin() {
+    flush();
     return elements.begin();
 }
 
 template<class T>
 typename OrderedSet<T>::const_iterator OrderedSet<T>::begin() const {
-    return elements.begin();
+    flush();
+    return elements.cbegin();
 }
 
 template<class T>
 typename OrderedSet<T>::const_iterator OrderedSet<T>::cbegin() const {
+    flush();
     return elements.cbegin();
 }
 
 template<class T>
 typename OrderedSet<T>::iterator OrderedSet<T>::end() {
+    flush();
     return elements.end();
 }
 
 template<class T>
 typename OrderedSet<T>::const_iterator OrderedSet<T>::end() const {
-    return elements.end();
+    flush();
+    return elements.cend();
 }
 
 template<class T>
 typename OrderedSet<T>::const_iterator OrderedSet<T>::cend() const {
+    flush();
     return elements.cend();
-}
\ No newline at end of file
+}
+
+template<class T>
+template<class U>
+void OrderedSet<T>::insert(U &&element) {
+    if (bufferCapacity > 0) {
+        if (indexOf(element) != NPOS || kstd::find(pending.begin(), pending.end(), element) != pending.end()) {
+            return;
+        }
+        pending.pushBack(std::forward<U>(element));
+        buffered.store(true, std::memory_order_relaxed);
+        if (pending.size() >= bufferCapacity) {
+            flush();
+        }
+        return;
+    }
+
+    size_type pos = position(element);
+    if (pos < elements.size() && elements[pos] == element) {
+        return;
+    }
+    elements.insert(elements.cbegin() + pos, std::forward<U>(element));
+    layoutStale.store(true, std::memory_order_relaxed);
+}
+
+template<class T>
+void OrderedSet<T>::flush() const {
+    if (!buffered.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // another reader may have merged the buffer while this one waited for the lock
+    std::lock_guard<std::mutex> lock(lazyMutex());
+    if (!buffered.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!pending.empty()) {
+        kstd::sort(pending.begin(), pending.end());
+        mergeSorted(elements, pending);
+        pending.clear();
+        layoutStale.store(true, std::memory_order_relaxed);
+    }
+    buffered.store(false, std::memory_order_release);
+}
+
+template<class T>
+std::mutex &OrderedSet<T>::lazyMutex() const {
+    static std::mutex mutexes[LAZY_MUTEXES];
+    return mutexes[reinterpret_cast<uintptr_t>(this) / sizeof(OrderedSet<T>) % LAZY_MUTEXES];
+}
+
+template<class T>
+void OrderedSet<T>::mergeSorted(Vector<T> &target, Vector<T> &batch) {
+    // the whole batch goes after the current elements
+    if (target.empty() || target.back() < batch.front()) {
+        target.reserve(target.size() + batch.size());
+        for (auto &element: batch) {
+            target.pushBack(std::move(element));
+        }
+        return;
+    }
+
+    Vector<T> merged(target.size() + batch.size(), target.resource());
+    size_type i = 0;
+    size_type j = 0;
+    while (i < target.size() && j < batch.size()) {
+        if (target[i] < batch[j]) {
+            merged.pushBack(std::move(target[i++]));
+        } else if (batch[j] < target[i]) {
+            merged.pushBack(std::move(batch[j++]));
+        } else {
+            merged.pushBack(std::move(target[i++]));
+            ++j;
+        }
+    }
+    for (; i < target.size(); ++i) {
+        merged.pushBack(std::move(target[i]));
+    }
+    for (; j < batch.size(); ++j) {
+        merged.pushBack(std::move(batch[j]));
+    }
+    target = std::move(merged);
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::position(const T &element) const {
+    return kstd::lowerBound(elements.data(), elements.size(), element);
+}
+
+template<class T>
+void OrderedSet<T>::normalize(Vector<T> &values) {
+    if (!kstd::isSorted(values.begin(), values.end())) {
+        kstd::sort(values.begin(), values.end());
+    }
+    size_type unique = kstd::unique(values.begin(), values.end()) - values.begin();
+    values.erase(values.cbegin() + unique, values.cend());
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::upperPosition(const T &element) const {
+    // the elements are unique, so at most one of them equals element
+    size_type pos = position(element);
+    return pos < elements.size() && !(element < elements[pos]) ? pos + 1 : pos;
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::indexOf(const T &element) const {
+    if (lookupLayout) {
+        refreshLayout();
+        size_type node = layoutLowerBound(element);
+        return node != 0 && layout[node] == element ? ranks[node] : NPOS;
+    }
+
+    size_type pos = position(element);
+    return pos < elements.size() && elements[pos] == element ? pos : NPOS;
+}
+
+template<class T>
+void OrderedSet<T>::refreshLayout() const {
+    if (!layoutStale.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(lazyMutex());
+    if (layoutStale.load(std::memory_order_relaxed)) {
+        buildLayout();
+        layoutStale.store(false, std::memory_order_release);
+    }
+}
+
+template<class T>
+void OrderedSet<T>::buildLayout() const {
+    layout.clear();
+    ranks.clear();
+    if (elements.empty()) {
+        return;
+    }
+
+    layout.reserve(elements.size() + 1);
+    ranks.reserve(elements.size() + 1);
+    // filled in BFS order, node k is at k and its children are 2k and 2k + 1
+    for (size_type i = 0; i <= elements.size(); ++i) {
+        layout.pushBack(elements[i > 0 ? i - 1 : 0]);
+        ranks.pushBack(0);
+    }
+    fillLayout(1, 0);
+}
+
+template<class T>
+MemoryResource *OrderedSet<T>::layoutResource() {
+    static AlignedResource resource(kstd::CACHE_LINE_SIZE, mallocResource());
+    return &resource;
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::fillLayout(size_type node, size_type idx) const {
+    // an in-order walk of the implicit tree hands out the sorted elements
+    if (node < layout.size()) {
+        idx = fillLayout(2 * node, idx);
+        layout[node] = elements[idx];
+        ranks[node] = idx++;
+        idx = fillLayout(2 * node + 1, idx);
+    }
+    return idx;
+}
+
+template<class T>
+typename OrderedSet<T>::size_type OrderedSet<T>::layoutLowerBound(const T &element) const {
+    const T *keys = layout.data();
+    size_type n = layout.empty() ? 0 : layout.size() - 1;
+
+    size_type node = 1;
+    while (node <= n) {
+        // the PREFETCH_SPAN descendants of a node a few levels down start on a cache line boundary,
+        // the line is loaded while the levels above are compared
+        size_type ahead = PREFETCH_SPAN * node;
+        kstd::prefetch(keys + (ahead <= n ? ahead : 0));
+        node = 2 * node + (keys[node] < element);
+    }
+
+    // every right turn appended a 1, the lower bound is where the last left turn was taken
+    while (node & 1) {
+        node >>= 1;
+    }
+    return node >> 1;
+}
+
+template<class T>
+typename OrderedSet<T>::size_type
+OrderedSet<T>::gallop(const Vector<T> &values, size_type from, size_type to, const T &key) {
+    // everything before from is less than key
+    size_type step = 1;
+    size_type bound = from;
+    while (bound < to && values[bound] < key) {
+        from = bound + 1;
+        bound = to - from > step ? from + step : to;
+        step <<= 1;
+    }
+
+    while (from < bound) {
+        size_type mid = from + (bound - from) / 2;
+        if (values[mid] < key) {
+            from = mid + 1;
+        } else {
+            bound = mid;
+        }
+    }
+    return from;
+}
+
+template<class T>
+template<class EmitA, class EmitB>
+void OrderedSet<T>::merge(const Vector<T> &a, const Vector<T> &b, bool keepA, bool keepB, bool keepCommon,
+                          EmitA emitA, EmitB emitB) {
+    size_type n = a.size();
+    size_type m = b.size();
+    bool gallopA = n / GALLOP_RATIO > m;
+    bool gallopB = m / GALLOP_RATIO > n;
+
+    size_type i = 0;
+    size_type j = 0;
+    while (i < n && j < m) {
+        // skip the run of the larger side that is less than the next element of the smaller one
+        if (gallopA) {
+            size_type next = gallop(a, i, n, b[j]);
+            for (; keepA && i < next; ++i) {
+                emitA(i);
+            }
+            i = next;
+            if (i == n) {
+                break;
+            }
+        } else if (gallopB) {
+            size_type next = gallop(b, j, m, a[i]);
+            for (; keepB && j < next; ++j) {
+                emitB(j);
+            }
+            j = next;
+            if (j == m) {
+                break;
+            }
+        }
+
+        if (a[i] < b[j]) {
+            if (keepA) {
+                emitA(i);
+            }
+            ++i;
+        } else if (b[j] < a[i]) {
+            if (keepB) {
+                emitB(j);
+            }
+            ++j;
+        } else {
+            if (keepCommon) {
+                emitA(i);
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    for (; keepA && i < n; ++i) {
+        emitA(i);
+    }
+    for (; keepB && j < m; ++j) {
+        emitB(j);
+    }
+}
+
+template<class T>
+void OrderedSet<T>::compact(const OrderedSet<T> &other, bool keepA, bool keepCommon) {
+    size_type kept = 0;
+    merge(elements, other.elements, keepA, false, keepCommon,
+          [&](size_type i) {
+              if (kept != i) {
+                  elements[kept] = std::move(elements[i]);
+              }
+              ++kept;
+          },
+          [](size_type) {});
+    elements.erase(elements.cbegin() + kept, elements.cend());
+    layoutStale.store(true, std::memory_order_relaxed);
+}
+
+template<class T>
+void OrderedSet<T>::mergeFromBack(const OrderedSet<T> &other, bool keepCommon) {
+    const Vector<T> &b = other.elements;
+    size_type extra = 0;
+    merge(elements, b, false, true, false, [](size_type) {}, [&](size_type) { ++extra; });
+
+    // the slots for the elements only other has are filled with copies that get overwritten
+    size_type n = elements.size();
+    elements.reserve(n + extra);
+    for (size_type j = 0; j < extra; ++j) {
+        elements.pushBack(b[j]);
+    }
+
+    // the write position never falls behind the read position i
+    size_type write = n + extra;
+    size_type i = n;
+    size_type j = b.size();
+    while (j > 0) {
+        if (i > 0 && b[j - 1] < elements[i - 1]) {
+            --i;
+            if (--write != i) {
+                elements[write] = std::move(elements[i]);
+            }
+        } else if (i > 0 && !(elements[i - 1] < b[j - 1])) {
+            --i;
+            --j;
+            if (keepCommon && --write != i) {
+                elements[write] = std::move(elements[i]);
+            }
+        } else {
+            elements[--write] = b[--j];
+        }
+    }
+
+    // dropped common elements leave a gap between the untouched front and the merged back
+    if (write > i) {
+        size_type gap = write - i;
+        for (size_type from = write; from < n + extra; ++from) {
+            elements[from - gap] = std::move(elements[from]);
+        }
+        elements.erase(elements.cend() - gap, elements.cend());
+    }
+    layoutStale.store(true, std::memory_order_relaxed);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utility>
+#include "../TypeTraits/TypeTraits.hpp"
 
 template<class T, class U>
 struct Pair {
@@ -19,6 +20,12 @@ struct Pair {
     void swap(Pair<T, U> &with) noexcept;
 };
 
+namespace kstd {
+    template<class T, class U>
+    struct is_trivially_relocatable<Pair<T, U>>
+            : std::bool_constant<is_trivially_relocatable_v<T> && is_trivially_relocatable_v<U>> {};
+}
+
 template<class T, class U>
 Pair<T, U>::Pair() : first{}, second{} {}
 
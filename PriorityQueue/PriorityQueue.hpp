@@ -0,0 +1,334 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include "../Vector/Vector.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+/*
+ * d-ary heap on top of Vector
+ *
+ * top() is the element that compares lowest, with std::greater it is the highest
+ * the children of i are Arity * i + 1 ... Arity * i + Arity, the default of 4
+ * keeps the children of a node on one cache line for small T and halves the depth
+ *
+ * push returns a handle that keeps naming the element while it moves around the heap,
+ * it is used to change the priority in O(log n) with decreaseKey / update or to erase it
+ * the handle of a popped or erased element is reused by a later push
+ */
+template<class T, class Compare = std::less<T>, size_t Arity = 4>
+class PriorityQueue {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef size_t handle;
+    typedef const T &const_reference;
+
+    static constexpr size_type NPOS = size_type(-1);
+
+private:
+    Vector<T> heap;
+    // handle of the element at every heap position
+    Vector<handle> handles;
+    // heap position of every handle, NPOS for a free handle
+    Vector<size_type> positions;
+    Vector<handle> freeHandles;
+    Compare compare;
+
+public:
+    explicit PriorityQueue(const Compare &compare = Compare(), MemoryResource *resource = defaultResource());
+
+    // builds the heap in O(n), the handles are the indices in elements
+    explicit PriorityQueue(Vector<T> elements, const Compare &compare = Compare());
+
+    // MARK: element access -d
+    const_reference top() const;
+
+    handle topHandle() const;
+
+    const_reference get(handle h) const;
+
+    bool contains(handle h) const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    void reserve(size_type capacity);
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: modifiers -d
+    handle push(const T &value);
+
+    handle push(T &&value);
+
+    template<class... Args>
+    handle emplace(Args &&... args);
+
+    void pop();
+
+    // value must not compare greater than the current one
+    void decreaseKey(handle h, const T &value);
+
+    // any new value, the element moves up or down as needed
+    void update(handle h, const T &value);
+
+    void erase(handle h);
+
+    void clear() noexcept;
+
+private:
+    size_type position(handle h) const;
+
+    handle newHandle();
+
+    // moves the element at idx towards the root / the leaves
+    void siftUp(size_type idx);
+
+    void siftDown(size_type idx);
+
+    void place(size_type idx, T &&value, handle h);
+
+    void removeAt(size_type idx);
+};
+
+template<class T, class Compare, size_t Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(const Compare &compare, MemoryResource *resource)
+        : heap(resource), handles(resource), positions(resource), freeHandles(resource), compare(compare) {}
+
+template<class T, class Compare, size_t Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(Vector<T> elements, const Compare &compare)
+        : heap(std::move(elements)), handles(heap.resource()), positions(heap.resource()),
+          freeHandles(heap.resource()), compare(compare) {
+    size_type n = heap.size();
+    handles.reserve(n);
+    positions.reserve(n);
+    for (size_type i = 0; i < n; ++i) {
+        handles.pushBack(i);
+        positions.pushBack(i);
+    }
+
+    // Floyd: sift down every inner node, starting from the last one
+    if (n > 1) {
+        for (size_type idx = (n - 2) / Arity + 1; idx-- > 0;) {
+            siftDown(idx);
+        }
+    }
+}
+
+// MARK: element access -i
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::const_reference PriorityQueue<T, Compare, Arity>::top() const {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    return heap[0];
+}
+
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::handle PriorityQueue<T, Compare, Arity>::topHandle() const {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    return handles[0];
+}
+
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::const_reference PriorityQueue<T, Compare, Arity>::get(handle h) const {
+    return heap[position(h)];
+}
+
+template<class T, class Compare, size_t Arity>
+bool PriorityQueue<T, Compare, Arity>::contains(handle h) const noexcept {
+    return h < positions.size() && positions[h] != NPOS;
+}
+
+// MARK: capacity -i
+template<class T, class Compare, size_t Arity>
+bool PriorityQueue<T, Compare, Arity>::empty() const noexcept {
+    return heap.empty();
+}
+
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::size_type PriorityQueue<T, Compare, Arity>::size() const noexcept {
+    return heap.size();
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::reserve(size_type capacity) {
+    heap.reserve(capacity);
+    handles.reserve(capacity);
+    positions.reserve(capacity);
+}
+
+template<class T, class Compare, size_t Arity>
+MemoryResource *PriorityQueue<T, Compare, Arity>::resource() const noexcept {
+    return heap.resource();
+}
+
+// MARK: modifiers -i
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::handle PriorityQueue<T, Compare, Arity>::push(const T &value) {
+    return emplace(value);
+}
+
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::handle PriorityQueue<T, Compare, Arity>::push(T &&value) {
+    return emplace(std::move(value));
+}
+
+template<class T, class Compare, size_t Arity>
+template<class... Args>
+typename PriorityQueue<T, Compare, Arity>::handle PriorityQueue<T, Compare, Arity>::emplace(Args &&... args) {
+    handle h = newHandle();
+    heap.emplaceBack(std::forward<Args>(args)...);
+    handles.pushBack(h);
+    positions[h] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+    return h;
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::pop() {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    removeAt(0);
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::decreaseKey(handle h, const T &value) {
+    size_type idx = position(h);
+    if (compare(heap[idx], value)) {
+        throw std::invalid_argument("the new key is greater than the current one!");
+    }
+    heap[idx] = value;
+    siftUp(idx);
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::update(handle h, const T &value) {
+    size_type idx = position(h);
+    bool decreased = compare(value, heap[idx]);
+    heap[idx] = value;
+    if (decreased) {
+        siftUp(idx);
+    } else {
+        siftDown(idx);
+    }
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::erase(handle h) {
+    removeAt(position(h));
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::clear() noexcept {
+    heap.clear();
+    handles.clear();
+    positions.clear();
+    freeHandles.clear();
+}
+
+// MARK: helpers -i
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::size_type PriorityQueue<T, Compare, Arity>::position(handle h) const {
+    if (!contains(h)) {
+        throw std::out_of_range("handle is not in the queue!");
+    }
+    return positions[h];
+}
+
+template<class T, class Compare, size_t Arity>
+typename PriorityQueue<T, Compare, Arity>::handle PriorityQueue<T, Compare, Arity>::newHandle() {
+    if (!freeHandles.empty()) {
+        handle h = freeHandles.back();
+        freeHandles.popBack();
+        return h;
+    }
+    positions.pushBack(NPOS);
+    return positions.size() - 1;
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::siftUp(size_type idx) {
+    // the element is lifted out and the parents move down into the hole
+    T value = std::move(heap[idx]);
+    handle h = handles[idx];
+
+    while (idx > 0) {
+        size_type parent = (idx - 1) / Arity;
+        if (!compare(value, heap[parent])) {
+            break;
+        }
+        place(idx, std::move(heap[parent]), handles[parent]);
+        idx = parent;
+    }
+    place(idx, std::move(value), h);
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::siftDown(size_type idx) {
+    size_type n = heap.size();
+    T value = std::move(heap[idx]);
+    handle h = handles[idx];
+
+    while (true) {
+        size_type first = Arity * idx + 1;
+        if (first >= n) {
+            break;
+        }
+
+        size_type last = n - first > Arity ? first + Arity : n;
+        size_type best = first;
+        for (size_type child = first + 1; child < last; ++child) {
+            if (compare(heap[child], heap[best])) {
+                best = child;
+            }
+        }
+
+        if (!compare(heap[best], value)) {
+            break;
+        }
+        place(idx, std::move(heap[best]), handles[best]);
+        idx = best;
+    }
+    place(idx, std::move(value), h);
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::place(size_type idx, T &&value, handle h) {
+    heap[idx] = std::move(value);
+    handles[idx] = h;
+    positions[h] = idx;
+}
+
+template<class T, class Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::removeAt(size_type idx) {
+    handle removed = handles[idx];
+    size_type last = heap.size() - 1;
+
+    if (idx != last) {
+        bool lifted = compare(heap[last], heap[idx]);
+        place(idx, std::move(heap[last]), handles[last]);
+        heap.popBack();
+        handles.popBack();
+        if (lifted) {
+            siftUp(idx);
+        } else {
+            siftDown(idx);
+        }
+    } else {
+        heap.popBack();
+        handles.popBack();
+    }
+
+    positions[removed] = NPOS;
+    freeHandles.pushBack(removed);
+}
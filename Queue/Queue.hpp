@@ -1,10 +1,18 @@
 #pragma once
 
 #include <cstddef>
+#include <iterator>
 #include <utility>
 #include <stdexcept>
-
-template<class T>
+#include <new>
+#include "../Memory/Memory.hpp"
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../GrowthPolicy/GrowthPolicy.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../Pair/Pair.hpp"
+#include "../Span/Span.hpp"
+
+template<class T, class Policy = GrowthPolicy<>>
 class Queue {
 private:
     T *data;
@@ -12,18 +20,23 @@ private:
     size_t capacity;
     size_t put;
     size_t get;
+    MemoryResource *resource_;
 
     static const short INITIAL_CAPACITY = 4;
 public:
     Queue();
 
-    Queue(const Queue<T> &other);
+    explicit Queue(MemoryResource *resource);
+
+    Queue(const Queue<T, Policy> &other);
 
-    Queue(Queue<T> &&other) noexcept;
+    Queue(const Queue<T, Policy> &other, MemoryResource *resource);
 
-    Queue &operator=(const Queue<T> &other);
+    Queue(Queue<T, Policy> &&other) noexcept;
 
-    Queue &operator=(Queue<T> &&other) noexcept;
+    Queue &operator=(const Queue<T, Policy> &other);
+
+    Queue &operator=(Queue<T, Policy> &&other) noexcept;
 
     ~Queue();
 
@@ -37,38 +50,77 @@ public:
 
     const T &peek() const;
 
+    T &peek();
+
     void pop();
 
+    // MARK: bulk -d
+    // grows at most once and copies the elements into at most two runs of the ring,
+    // single pass input iterators fall back to one push per element
+    template<class InputIt>
+    void pushBulk(InputIt first, InputIt last);
+
+    // moves up to maxCount elements to out and returns how many were popped
+    template<class OutputIt>
+    size_t popBulk(OutputIt out, size_t maxCount);
+
+    // drops the first count elements, e.g. after they were read through peekSpan,
+    // throws std::out_of_range when there are fewer
+    void pop(size_t count);
+
+    // the elements in order as at most two contiguous runs,
+    // the second one is empty unless the content wraps around the end of the ring
+    Pair<Span<const T>, Span<const T>> peekSpan() const noexcept;
+
+    void shrinkToFit();
+
+    MemoryResource *resource() const noexcept;
+
 private:
     void free();
 
-    void copyFrom(const Queue<T> &other);
+    void copyFrom(const Queue<T, Policy> &other);
 
-    void moveFrom(Queue<T> &&other);
+    void moveFrom(Queue<T, Policy> &&other);
 
     void resize(size_t newCapacity);
 
+    size_t grownCapacity(size_t count = 1) const;
+
+    void shrinkAfterPop();
+
     static void next(size_t &idx, size_t max);
 };
 
-template<class T>
-Queue<T>::Queue()
-        : size_{0}, capacity{INITIAL_CAPACITY}, get{0}, put{0} {
-    data = new T[capacity];
+namespace kstd {
+    template<class T, class Policy>
+    struct is_trivially_relocatable<Queue<T, Policy>> : std::true_type {};
+}
+
+template<class T, class Policy>
+Queue<T, Policy>::Queue() : Queue<T, Policy>(defaultResource()) {}
+
+template<class T, class Policy>
+Queue<T, Policy>::Queue(MemoryResource *resource)
+        : size_{0}, capacity{INITIAL_CAPACITY}, get{0}, put{0}, resource_{resource} {
+    data = kstd::allocate<T>(resource_, capacity);
 }
 
-template<class T>
-Queue<T>::Queue(const Queue<T> &other) {
+template<class T, class Policy>
+Queue<T, Policy>::Queue(const Queue<T, Policy> &other) : Queue<T, Policy>(other, defaultResource()) {}
+
+template<class T, class Policy>
+Queue<T, Policy>::Queue(const Queue<T, Policy> &other, MemoryResource *resource) : resource_{resource} {
     copyFrom(other);
 }
 
-template<class T>
-Queue<T>::Queue(Queue<T> &&other) noexcept {
+template<class T, class Policy>
+Queue<T, Policy>::Queue(Queue<T, Policy> &&other) noexcept : resource_{other.resource_} {
     moveFrom(std::move(other));
 }
 
-template<class T>
-Queue<T> &Queue<T>::operator=(const Queue<T> &other) {
+template<class T, class Policy>
+Queue<T, Policy> &Queue<T, Policy>::operator=(const Queue<T, Policy> &other) {
     if (this != &other) {
         free();
         copyFrom(other);
@@ -76,93 +128,195 @@ Queue<T> &Queue<T>::operator=(const Queue<T> &other) {
     return *this;
 }
 
-template<class T>
-Queue<T> &Queue<T>::operator=(Queue<T> &&other) noexcept {
+template<class T, class Policy>
+Queue<T, Policy> &Queue<T, Policy>::operator=(Queue<T, Policy> &&other) noexcept {
     if (this != &other) {
         free();
+        resource_ = other.resource_;
         moveFrom(std::move(other));
     }
     return *this;
 }
 
-template<class T>
-Queue<T>::~Queue() {
+template<class T, class Policy>
+Queue<T, Policy>::~Queue() {
     free();
 }
 
-template<class T>
-bool Queue<T>::empty() const {
+template<class T, class Policy>
+bool Queue<T, Policy>::empty() const {
     return size_ == 0;
 }
 
-template<class T>
-size_t Queue<T>::size() const {
+template<class T, class Policy>
+size_t Queue<T, Policy>::size() const {
     return size_;
 }
 
-template<class T>
-void Queue<T>::push(const T &element) {
+template<class T, class Policy>
+void Queue<T, Policy>::push(const T &element) {
     if (size_ == capacity) {
-        resize(2 * capacity);
+        resize(grownCapacity());
     }
     size_++;
-    data[put] = element;
+    new(&data[put]) T(element);
     next(put, capacity);
 }
 
-template<class T>
-void Queue<T>::push(T &&element) {
+template<class T, class Policy>
+void Queue<T, Policy>::push(T &&element) {
     if (size_ == capacity) {
-        resize(2 * capacity);
+        resize(grownCapacity());
     }
     size_++;
-    data[put] = std::move(element);
+    new(&data[put]) T(std::move(element));
     next(put, capacity);
 }
 
-template<class T>
-const T &Queue<T>::peek() const {
+template<class T, class Policy>
+const T &Queue<T, Policy>::peek() const {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    return data[get];
+}
+
+template<class T, class Policy>
+T &Queue<T, Policy>::peek() {
     if (empty()) {
         throw std::logic_error("queue is empty");
     }
     return data[get];
 }
 
-template<class T>
-void Queue<T>::pop() {
+template<class T, class Policy>
+void Queue<T, Policy>::pop() {
     if (empty()) {
         throw std::logic_error("queue is empty");
     }
     size_--;
+    data[get].~T();
     next(get, capacity);
+    shrinkAfterPop();
+}
 
-    if (capacity > 4 * size_) {
-        resize(capacity / 2);
+template<class T, class Policy>
+template<class InputIt>
+void Queue<T, Policy>::pushBulk(InputIt first, InputIt last) {
+    if constexpr (!kstd::is_forward_iterator_v<InputIt>) {
+        // a single pass range cannot be measured up front, so it is pushed one element at a time
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    } else {
+        size_t count = std::distance(first, last);
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > capacity) {
+            resize(grownCapacity(count));
+        }
+
+        // [put, capacity) and then [0, ...) when the run wraps
+        size_t tail = capacity - put < count ? capacity - put : count;
+        first = kstd::uninitializedCopy(first, tail, data + put);
+        kstd::uninitializedCopy(first, count - tail, data);
+
+        size_ += count;
+        put = (put + count) % capacity;
     }
 }
 
-template<class T>
-void Queue<T>::free() {
-    delete[] data;
+template<class T, class Policy>
+template<class OutputIt>
+size_t Queue<T, Policy>::popBulk(OutputIt out, size_t maxCount) {
+    size_t count = size_ < maxCount ? size_ : maxCount;
+
+    for (size_t left = count; left > 0;) {
+        size_t run = capacity - get < left ? capacity - get : left;
+        if constexpr (std::is_trivially_copyable_v<T> && kstd::is_contiguous_iterator_v<OutputIt>
+                      && std::is_same_v<std::remove_reference_t<decltype(*out)>, T>) {
+            std::memcpy(static_cast<void *>(&*out), static_cast<const void *>(data + get), run * sizeof(T));
+            out += run;
+        } else {
+            for (size_t i = 0; i < run; ++i, ++out) {
+                *out = std::move(data[get + i]);
+                data[get + i].~T();
+            }
+        }
+        get = (get + run) % capacity;
+        left -= run;
+    }
+
+    size_ -= count;
+    shrinkAfterPop();
+    return count;
+}
+
+template<class T, class Policy>
+void Queue<T, Policy>::pop(size_t count) {
+    if (count > size_) {
+        throw std::out_of_range("count is greater than the size of the queue");
+    }
+
+    for (size_t left = count; left > 0;) {
+        size_t run = capacity - get < left ? capacity - get : left;
+        kstd::destroy(data + get, data + get + run);
+        get = (get + run) % capacity;
+        left -= run;
+    }
+
+    size_ -= count;
+    shrinkAfterPop();
+}
+
+template<class T, class Policy>
+Pair<Span<const T>, Span<const T>> Queue<T, Policy>::peekSpan() const noexcept {
+    size_t tail = capacity - get < size_ ? capacity - get : size_;
+    return Pair<Span<const T>, Span<const T>>(Span<const T>(data + get, tail),
+                                              Span<const T>(data, size_ - tail));
+}
+
+template<class T, class Policy>
+void Queue<T, Policy>::shrinkToFit() {
+    if (capacity > size_) {
+        resize(size_);
+    }
+}
+
+template<class T, class Policy>
+MemoryResource *Queue<T, Policy>::resource() const noexcept {
+    return resource_;
+}
+
+template<class T, class Policy>
+void Queue<T, Policy>::free() {
+    for (size_t i = 0, idx = get; i < size_; ++i) {
+        data[idx].~T();
+        next(idx, capacity);
+    }
+    kstd::deallocate(resource_, data, capacity);
     data = nullptr;
+    size_ = capacity = get = put = 0;
 }
 
-template<class T>
-void Queue<T>::copyFrom(const Queue<T> &other) {
-    size_ = other.size_;
+template<class T, class Policy>
+void Queue<T, Policy>::copyFrom(const Queue<T, Policy> &other) {
+    size_ = 0;
     capacity = other.capacity;
-    get = other.get;
-    put = other.put;
+    get = 0;
 
-    data = new T[capacity];
+    data = kstd::allocate<T>(resource_, capacity);
 
-    for (size_t i = 0; i < size_; ++i) {
-        data[i] = other.data[i];
+    for (size_t idx = other.get; size_ < other.size_; ++size_) {
+        new(&data[size_]) T(other.data[idx]);
+        next(idx, capacity);
     }
+    put = size_ == capacity ? 0 : size_;
 }
 
-template<class T>
-void Queue<T>::moveFrom(Queue<T> &&other) {
+template<class T, class Policy>
+void Queue<T, Policy>::moveFrom(Queue<T, Policy> &&other) {
     size_ = other.size_;
     capacity = other.capacity;
     get = other.get;
@@ -170,25 +324,52 @@ void Queue<T>::moveFrom(Queue<T> &&other) {
 
     data = other.data;
     other.data = nullptr;
+    other.size_ = other.capacity = other.get = other.put = 0;
 }
 
-template<class T>
-void Queue<T>::resize(size_t newCapacity) {
-    capacity = newCapacity;
-    T *temp = new T[capacity];
+template<class T, class Policy>
+void Queue<T, Policy>::resize(size_t newCapacity) {
+    // a full ring that doubles is grown in place, only the
+    // wrapped part [0, put) has to follow the old end
+    if (kstd::is_trivially_relocatable_v<T> && size_ == capacity && get >= put && newCapacity >= capacity + put) {
+        data = kstd::reallocate(resource_, data, capacity, capacity, newCapacity);
+        kstd::relocate(data, data + put, data + capacity);
+        put = (capacity + put) % newCapacity;
+        capacity = newCapacity;
+        return;
+    }
+
+    T *temp = kstd::allocate<T>(resource_, newCapacity);
 
-    for (size_t i = 0; i < size_; ++i) {
-        temp[i] = data[get];
-        next(get, capacity);
+    if (get < put || size_ == 0) {
+        kstd::relocate(data + get, data + get + size_, temp);
+    } else {
+        kstd::relocate(data + get, data + capacity, temp);
+        kstd::relocate(data, data + put, temp + (capacity - get));
     }
 
-    free();
+    kstd::deallocate(resource_, data, capacity);
     data = temp;
+    capacity = newCapacity;
     get = 0;
-    put = size_;
+    put = size_ == capacity ? 0 : size_;
+}
+
+template<class T, class Policy>
+size_t Queue<T, Policy>::grownCapacity(size_t count) const {
+    size_t required = size_ + count < INITIAL_CAPACITY ? INITIAL_CAPACITY : size_ + count;
+    return Policy::grow(capacity, required, sizeof(T));
+}
+
+template<class T, class Policy>
+void Queue<T, Policy>::shrinkAfterPop() {
+    size_t newCapacity = Policy::shrink(capacity, size_);
+    if (newCapacity < capacity) {
+        resize(newCapacity);
+    }
 }
 
-template<class T>
-void Queue<T>::next(size_t &idx, size_t max) {
+template<class T, class Policy>
+void Queue<T, Policy>::next(size_t &idx, size_t max) {
     idx = (idx == max - 1) ? 0 : ++idx;
 }
\ No newline at end of file
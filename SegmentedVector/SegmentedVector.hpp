@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <iterator>
+#include <new>
+#include "../Vector/Vector.hpp"
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+/*
+ * vector made of fixed size chunks
+ *
+ * growing only allocates a new chunk and appends a pointer to the chunk table,
+ * the elements themselves are never copied or moved,
+ * so pointers, references and iterators to them stay valid
+ * until the element is removed
+ *
+ * ChunkSize is a power of two, so indexing is a shift and a mask
+ * the default fills roughly 4 KiB per chunk
+ */
+template<class T>
+constexpr size_t defaultChunkSize() {
+    size_t size = 1;
+    while (2 * size * sizeof(T) <= 4096) {
+        size *= 2;
+    }
+    return size;
+}
+
+// an index into the owner, so growing the chunk table does not invalidate it
+template<class S, class V>
+class SegmentedIterator {
+public:
+    typedef V value_type;
+    typedef V *pointer;
+    typedef V &reference;
+    typedef ptrdiff_t difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+
+private:
+    S *owner;
+    size_t idx;
+
+public:
+    SegmentedIterator(S *owner = nullptr, size_t idx = 0) : owner{owner}, idx{idx} {}
+
+    reference operator*() const {
+        return (*owner)[idx];
+    }
+
+    pointer operator->() const {
+        return &operator*();
+    }
+
+    SegmentedIterator &operator++() {
+        ++idx;
+        return *this;
+    }
+
+    SegmentedIterator operator++(int) {
+        SegmentedIterator temp(*this);
+        ++idx;
+        return temp;
+    }
+
+    SegmentedIterator &operator--() {
+        --idx;
+        return *this;
+    }
+
+    SegmentedIterator operator--(int) {
+        SegmentedIterator temp(*this);
+        --idx;
+        return temp;
+    }
+
+    SegmentedIterator &operator+=(difference_type d) {
+        idx += d;
+        return *this;
+    }
+
+    SegmentedIterator &operator-=(difference_type d) {
+        idx -= d;
+        return *this;
+    }
+
+    SegmentedIterator operator+(difference_type d) const {
+        return SegmentedIterator(owner, idx + d);
+    }
+
+    SegmentedIterator operator-(difference_type d) const {
+        return SegmentedIterator(owner, idx - d);
+    }
+
+    difference_type operator-(const SegmentedIterator &other) const {
+        return difference_type(idx) - difference_type(other.idx);
+    }
+
+    reference operator[](difference_type d) const {
+        return *(*this + d);
+    }
+
+    size_t index() const {
+        return idx;
+    }
+
+    bool operator==(const SegmentedIterator &other) const {
+        return idx == other.idx;
+    }
+
+    bool operator!=(const SegmentedIterator &other) const {
+        return idx != other.idx;
+    }
+
+    bool operator<(const SegmentedIterator &other) const {
+        return idx < other.idx;
+    }
+
+    bool operator<=(const SegmentedIterator &other) const {
+        return idx <= other.idx;
+    }
+
+    bool operator>(const SegmentedIterator &other) const {
+        return idx > other.idx;
+    }
+
+    bool operator>=(const SegmentedIterator &other) const {
+        return idx >= other.idx;
+    }
+};
+
+template<class T, size_t ChunkSize = defaultChunkSize<T>()>
+class SegmentedVector {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "the chunk size must be a power of two");
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef SegmentedIterator<SegmentedVector<T, ChunkSize>, value_type> iterator;
+    typedef SegmentedIterator<const SegmentedVector<T, ChunkSize>, const value_type> const_iterator;
+
+private:
+    Vector<pointer> chunks;
+    size_type size_;
+    MemoryResource *resource_;
+
+public:
+    // MARK: big 6 -d
+    SegmentedVector();
+
+    explicit SegmentedVector(MemoryResource *resource);
+
+    SegmentedVector(std::initializer_list<value_type> data, MemoryResource *resource = defaultResource());
+
+    SegmentedVector(const SegmentedVector<T, ChunkSize> &other);
+
+    SegmentedVector(const SegmentedVector<T, ChunkSize> &other, MemoryResource *resource);
+
+    SegmentedVector(SegmentedVector<T, ChunkSize> &&other) noexcept;
+
+    SegmentedVector<T, ChunkSize> &operator=(const SegmentedVector<T, ChunkSize> &other);
+
+    SegmentedVector<T, ChunkSize> &operator=(SegmentedVector<T, ChunkSize> &&other) noexcept;
+
+    ~SegmentedVector();
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: element access -d
+    const_reference at(size_type idx) const;
+
+    reference at(size_type idx);
+
+    const_reference operator[](size_type idx) const;
+
+    reference operator[](size_type idx);
+
+    const_reference front() const;
+
+    reference front();
+
+    const_reference back() const;
+
+    reference back();
+
+    // MARK: iterators -d
+    const_iterator begin() const noexcept;
+
+    iterator begin() noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator cend() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    size_type chunkCount() const noexcept;
+
+    void reserve(size_type capacity);
+
+    void shrinkToFit();
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    void pushBack(const T &value);
+
+    void pushBack(T &&value);
+
+    template<class... Args>
+    reference emplaceBack(Args &&... args);
+
+    void popBack();
+
+    void swap(SegmentedVector<T, ChunkSize> &other);
+
+private:
+    // MARK: big 6 helpers -d
+    void free();
+
+    void copyFrom(const SegmentedVector<T, ChunkSize> &other);
+
+    void moveFrom(SegmentedVector<T, ChunkSize> &&other);
+
+    // MARK: storage helpers -d
+    void addChunk();
+
+    static size_type chunk(size_type idx);
+
+    static size_type offset(size_type idx);
+};
+
+namespace kstd {
+    template<class T, size_t ChunkSize>
+    struct is_trivially_relocatable<SegmentedVector<T, ChunkSize>> : std::true_type {};
+}
+
+// MARK: big 6 -i
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector() : SegmentedVector<T, ChunkSize>(defaultResource()) {}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector(MemoryResource *resource)
+        : chunks(resource), size_{0}, resource_{resource} {}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector(std::initializer_list<value_type> data, MemoryResource *resource)
+        : SegmentedVector<T, ChunkSize>(resource) {
+    reserve(data.size());
+    for (auto el = data.begin(); el != data.end(); ++el) {
+        emplaceBack(*el);
+    }
+}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector(const SegmentedVector<T, ChunkSize> &other)
+        : SegmentedVector<T, ChunkSize>(other, defaultResource()) {}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector(const SegmentedVector<T, ChunkSize> &other, MemoryResource *resource)
+        : SegmentedVector<T, ChunkSize>(resource) {
+    copyFrom(other);
+}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector(SegmentedVector<T, ChunkSize> &&other) noexcept
+        : SegmentedVector<T, ChunkSize>(other.resource_) {
+    moveFrom(std::move(other));
+}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize> &SegmentedVector<T, ChunkSize>::operator=(const SegmentedVector<T, ChunkSize> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize> &SegmentedVector<T, ChunkSize>::operator=(SegmentedVector<T, ChunkSize> &&other) noexcept {
+    if (this != &other) {
+        free();
+        resource_ = other.resource_;
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T, size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::~SegmentedVector() {
+    free();
+}
+
+template<class T, size_t ChunkSize>
+MemoryResource *SegmentedVector<T, ChunkSize>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: element access -i
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_reference SegmentedVector<T, ChunkSize>::at(size_type idx) const {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::reference SegmentedVector<T, ChunkSize>::at(size_type idx) {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_reference
+SegmentedVector<T, ChunkSize>::operator[](size_type idx) const {
+    return chunks[chunk(idx)][offset(idx)];
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::reference SegmentedVector<T, ChunkSize>::operator[](size_type idx) {
+    return chunks[chunk(idx)][offset(idx)];
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_reference SegmentedVector<T, ChunkSize>::front() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return operator[](0);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::reference SegmentedVector<T, ChunkSize>::front() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return operator[](0);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_reference SegmentedVector<T, ChunkSize>::back() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return operator[](size_ - 1);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::reference SegmentedVector<T, ChunkSize>::back() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return operator[](size_ - 1);
+}
+
+// MARK: iterators -i
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_iterator SegmentedVector<T, ChunkSize>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::iterator SegmentedVector<T, ChunkSize>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_iterator SegmentedVector<T, ChunkSize>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_iterator SegmentedVector<T, ChunkSize>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::iterator SegmentedVector<T, ChunkSize>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::const_iterator SegmentedVector<T, ChunkSize>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+// MARK: capacity -i
+template<class T, size_t ChunkSize>
+bool SegmentedVector<T, ChunkSize>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::size_type SegmentedVector<T, ChunkSize>::size() const noexcept {
+    return size_;
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::size_type SegmentedVector<T, ChunkSize>::capacity() const noexcept {
+    return chunks.size() * ChunkSize;
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::size_type SegmentedVector<T, ChunkSize>::chunkCount() const noexcept {
+    return chunks.size();
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::reserve(size_type capacity) {
+    chunks.reserve(chunk(capacity + ChunkSize - 1));
+    while (this->capacity() < capacity) {
+        addChunk();
+    }
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::shrinkToFit() {
+    size_type needed = chunk(size_ + ChunkSize - 1);
+    while (chunks.size() > needed) {
+        kstd::deallocate(resource_, chunks.back(), ChunkSize);
+        chunks.popBack();
+    }
+    chunks.shrinkToFit();
+}
+
+// MARK: modifiers -i
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::clear() noexcept {
+    for (size_type c = 0; c * ChunkSize < size_; ++c) {
+        size_type count = size_ - c * ChunkSize < ChunkSize ? size_ - c * ChunkSize : ChunkSize;
+        kstd::destroy(chunks[c], chunks[c] + count);
+    }
+    size_ = 0;
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::pushBack(const T &value) {
+    emplaceBack(value);
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::pushBack(T &&value) {
+    emplaceBack(std::move(value));
+}
+
+template<class T, size_t ChunkSize>
+template<class... Args>
+typename SegmentedVector<T, ChunkSize>::reference SegmentedVector<T, ChunkSize>::emplaceBack(Args &&... args) {
+    // existing elements never move, so args stay valid across addChunk
+    if (size_ == capacity()) {
+        addChunk();
+    }
+
+    pointer slot = &chunks[chunk(size_)][offset(size_)];
+    new(slot) T(std::forward<Args>(args)...);
+    size_++;
+    return *slot;
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::popBack() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    size_--;
+    chunks[chunk(size_)][offset(size_)].~T();
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::swap(SegmentedVector<T, ChunkSize> &other) {
+    chunks.swap(other.chunks);
+    kstd::swap(size_, other.size_);
+    kstd::swap(resource_, other.resource_);
+}
+
+// MARK: big 6 helpers -i
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::free() {
+    clear();
+    for (size_type c = 0; c < chunks.size(); ++c) {
+        kstd::deallocate(resource_, chunks[c], ChunkSize);
+    }
+    chunks.clear();
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::copyFrom(const SegmentedVector<T, ChunkSize> &other) {
+    reserve(other.size_);
+    for (size_type i = 0; i < other.size_; ++i) {
+        emplaceBack(other[i]);
+    }
+}
+
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::moveFrom(SegmentedVector<T, ChunkSize> &&other) {
+    chunks = std::move(other.chunks);
+    size_ = other.size_;
+    other.size_ = 0;
+}
+
+// MARK: storage helpers -i
+template<class T, size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::addChunk() {
+    chunks.pushBack(kstd::allocate<T>(resource_, ChunkSize));
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::size_type SegmentedVector<T, ChunkSize>::chunk(size_type idx) {
+    return idx / ChunkSize;
+}
+
+template<class T, size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::size_type SegmentedVector<T, ChunkSize>::offset(size_type idx) {
+    return idx % ChunkSize;
+}
@@ -0,0 +1,144 @@
+#include "Simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define KSTD_SIMD_X86 1
+#endif
+
+namespace kstd {
+    namespace {
+        // the kernels compare signed lanes, unsigned values get their top bit flipped by bias first
+        typedef size_t (*Kernel32)(const uint32_t *, size_t, uint32_t, uint32_t);
+
+        typedef size_t (*Kernel64)(const uint64_t *, size_t, uint64_t, uint64_t);
+
+        size_t countLess32Scalar(const uint32_t *data, size_t count, uint32_t key, uint32_t bias) {
+            int32_t biased = int32_t(key ^ bias);
+            size_t less = 0;
+            for (size_t i = 0; i < count; ++i) {
+                less += int32_t(data[i] ^ bias) < biased;
+            }
+            return less;
+        }
+
+        size_t countLess64Scalar(const uint64_t *data, size_t count, uint64_t key, uint64_t bias) {
+            int64_t biased = int64_t(key ^ bias);
+            size_t less = 0;
+            for (size_t i = 0; i < count; ++i) {
+                less += int64_t(data[i] ^ bias) < biased;
+            }
+            return less;
+        }
+
+#ifdef KSTD_SIMD_X86
+        __attribute__((target("avx2,popcnt")))
+        size_t countLess32Avx2(const uint32_t *data, size_t count, uint32_t key, uint32_t bias) {
+            __m256i flip = _mm256_set1_epi32(int(bias));
+            __m256i pivot = _mm256_set1_epi32(int(key ^ bias));
+            size_t less = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i lanes = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + i)), flip);
+                __m256i mask = _mm256_cmpgt_epi32(pivot, lanes);
+                less += _mm_popcnt_u32(unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(mask))));
+            }
+            return less + countLess32Scalar(data + i, count - i, key, bias);
+        }
+
+        __attribute__((target("sse2")))
+        size_t countLess32Sse2(const uint32_t *data, size_t count, uint32_t key, uint32_t bias) {
+            __m128i flip = _mm_set1_epi32(int(bias));
+            __m128i pivot = _mm_set1_epi32(int(key ^ bias));
+            size_t less = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128i lanes = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + i)), flip);
+                __m128i mask = _mm_cmpgt_epi32(pivot, lanes);
+                less += __builtin_popcount(unsigned(_mm_movemask_ps(_mm_castsi128_ps(mask))));
+            }
+            return less + countLess32Scalar(data + i, count - i, key, bias);
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        size_t countLess64Avx2(const uint64_t *data, size_t count, uint64_t key, uint64_t bias) {
+            __m256i flip = _mm256_set1_epi64x((long long) bias);
+            __m256i pivot = _mm256_set1_epi64x((long long) (key ^ bias));
+            size_t less = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256i lanes = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + i)), flip);
+                __m256i mask = _mm256_cmpgt_epi64(pivot, lanes);
+                less += _mm_popcnt_u32(unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(mask))));
+            }
+            return less + countLess64Scalar(data + i, count - i, key, bias);
+        }
+
+        __attribute__((target("sse4.2,popcnt")))
+        size_t countLess64Sse42(const uint64_t *data, size_t count, uint64_t key, uint64_t bias) {
+            __m128i flip = _mm_set1_epi64x((long long) bias);
+            __m128i pivot = _mm_set1_epi64x((long long) (key ^ bias));
+            size_t less = 0;
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                __m128i lanes = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + i)), flip);
+                __m128i mask = _mm_cmpgt_epi64(pivot, lanes);
+                less += _mm_popcnt_u32(unsigned(_mm_movemask_pd(_mm_castsi128_pd(mask))));
+            }
+            return less + countLess64Scalar(data + i, count - i, key, bias);
+        }
+#endif
+
+        Kernel32 pickKernel32() {
+#ifdef KSTD_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+                return countLess32Avx2;
+            }
+            if (__builtin_cpu_supports("sse2")) {
+                return countLess32Sse2;
+            }
+#endif
+            return countLess32Scalar;
+        }
+
+        Kernel64 pickKernel64() {
+#ifdef KSTD_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+                return countLess64Avx2;
+            }
+            if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+                return countLess64Sse42;
+            }
+#endif
+            return countLess64Scalar;
+        }
+
+        // picked on first use, so it is ready even for callers in other static initialisers
+        size_t countLess32(const uint32_t *data, size_t count, uint32_t key, uint32_t bias) {
+            static const Kernel32 kernel = pickKernel32();
+            return kernel(data, count, key, bias);
+        }
+
+        size_t countLess64(const uint64_t *data, size_t count, uint64_t key, uint64_t bias) {
+            static const Kernel64 kernel = pickKernel64();
+            return kernel(data, count, key, bias);
+        }
+    }
+
+    size_t countLess(const int32_t *data, size_t count, int32_t key) noexcept {
+        return countLess32(reinterpret_cast<const uint32_t *>(data), count, uint32_t(key), 0);
+    }
+
+    size_t countLess(const uint32_t *data, size_t count, uint32_t key) noexcept {
+        return countLess32(data, count, key, uint32_t(1) << 31);
+    }
+
+    size_t countLess(const int64_t *data, size_t count, int64_t key) noexcept {
+        return countLess64(reinterpret_cast<const uint64_t *>(data), count, uint64_t(key), 0);
+    }
+
+    size_t countLess(const uint64_t *data, size_t count, uint64_t key) noexcept {
+        return countLess64(data, count, key, uint64_t(1) << 63);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "../Memory/Memory.hpp"
+
+/*
+ * vectorised kernels for short sorted blocks of integers
+ *
+ * the instruction set is picked once at runtime from what the cpu supports,
+ * AVX2 or SSE on x86 with a scalar loop everywhere else,
+ * so the same binary runs on every x86-64 host
+ */
+namespace kstd {
+    // how many of the first count elements are less than key
+    // on a sorted block that is the offset of the lower bound
+    size_t countLess(const int32_t *data, size_t count, int32_t key) noexcept;
+
+    size_t countLess(const uint32_t *data, size_t count, uint32_t key) noexcept;
+
+    size_t countLess(const int64_t *data, size_t count, int64_t key) noexcept;
+
+    size_t countLess(const uint64_t *data, size_t count, uint64_t key) noexcept;
+
+    // the fixed width integer with the same size and signedness as T, void if there is none
+    template<class T, class = void>
+    struct simd_key {
+        typedef void type;
+    };
+
+    template<class T>
+    struct simd_key<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                        (sizeof(T) == 4 || sizeof(T) == 8)>> {
+        typedef std::conditional_t<sizeof(T) == 4,
+                std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>,
+                std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>> type;
+    };
+
+    template<class T>
+    using simd_key_t = typename simd_key<T>::type;
+
+    template<class T>
+    inline constexpr bool has_simd_key_v = !std::is_void_v<simd_key_t<T>>;
+
+    // the first element of a sorted array that is not less than key,
+    // integer keys are binary searched down to two cache lines and finished with countLess
+    template<class T>
+    size_t lowerBound(const T *data, size_t count, const T &key) {
+        size_t left = 0;
+        size_t right = count;
+
+        if constexpr (has_simd_key_v<T>) {
+            typedef simd_key_t<T> Key;
+            const size_t BLOCK = 2 * CACHE_LINE_SIZE / sizeof(T);
+
+            while (right - left > BLOCK) {
+                size_t mid = left + (right - left) / 2;
+                if (data[mid] < key) {
+                    left = mid + 1;
+                } else {
+                    right = mid;
+                }
+            }
+            return left + countLess(reinterpret_cast<const Key *>(data + left), right - left, Key(key));
+        }
+
+        while (left < right) {
+            size_t mid = left + (right - left) / 2;
+            if (data[mid] < key) {
+                left = mid + 1;
+            } else {
+                right = mid;
+            }
+        }
+        return left;
+    }
+}
@@ -0,0 +1,726 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <stdexcept>
+#include <new>
+#include "../ArrayIterator/ArrayIterator.hpp"
+#include "../Algorithm/Algorithm.hpp"
+#include "../Memory/Memory.hpp"
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../GrowthPolicy/GrowthPolicy.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+/*
+ * Vector with a small buffer optimisation
+ *
+ * the first N elements live inside the object itself,
+ * the storage spills to the heap only when the N + 1st element is added
+ * and comes back inline once the capacity shrinks to N or less
+ *
+ * moving a small vector moves its elements one by one,
+ * moving a spilled one just steals the heap buffer
+ *
+ * the heap capacity follows Policy like in Vector
+ */
+template<class T, size_t N, class Policy = GrowthPolicy<>>
+class SmallVector {
+    static_assert(N > 0, "a small vector needs at least one inline slot");
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef ArrayIterator<value_type> iterator;
+    typedef ArrayIterator<const value_type> const_iterator;
+    typedef Policy growth_policy;
+
+private:
+    pointer data_;
+    size_type size_;
+    size_type capacity_;
+    MemoryResource *resource_;
+
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+
+public:
+    // MARK: big 6 -d
+    SmallVector();
+
+    explicit SmallVector(MemoryResource *resource);
+
+    SmallVector(std::initializer_list<value_type> data, MemoryResource *resource = defaultResource());
+
+    explicit SmallVector(size_type capacity, MemoryResource *resource = defaultResource());
+
+    SmallVector(const SmallVector<T, N, Policy> &other);
+
+    SmallVector(const SmallVector<T, N, Policy> &other, MemoryResource *resource);
+
+    SmallVector(SmallVector<T, N, Policy> &&other) noexcept;
+
+    SmallVector<T, N, Policy> &operator=(const SmallVector<T, N, Policy> &other);
+
+    SmallVector<T, N, Policy> &operator=(SmallVector<T, N, Policy> &&other) noexcept;
+
+    ~SmallVector();
+
+    void assign(size_type count, const T &value);
+
+    template<class InputIt>
+    void assign(InputIt first, InputIt last);
+
+    void assign(std::initializer_list<value_type> data);
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: element access -d
+    const_reference at(size_type idx) const;
+
+    reference at(size_type idx);
+
+    const_reference operator[](size_type idx) const;
+
+    reference operator[](size_type idx);
+
+    const_reference front() const;
+
+    reference front();
+
+    const_reference back() const;
+
+    reference back();
+
+    const_pointer data() const noexcept;
+
+    pointer data() noexcept;
+
+    // MARK: iterators -d
+    const_iterator begin() const noexcept;
+
+    iterator begin() noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator cend() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    bool isSmall() const noexcept;
+
+    void reserve(size_type capacity);
+
+    void shrinkToFit();
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    iterator insert(const_iterator pos, const T &value);
+
+    iterator insert(const_iterator pos, T &&value);
+
+    iterator insert(const_iterator pos, size_t count, const T &value);
+
+    template<class InputIt, class = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+
+    iterator erase(const_iterator pos);
+
+    iterator erase(const_iterator first, const_iterator last);
+
+    template<class UnaryPredicate>
+    size_type eraseIf(UnaryPredicate p);
+
+    void pushBack(const T &value);
+
+    void pushBack(T &&value);
+
+    template<class... Args>
+    reference emplaceBack(Args &&... args);
+
+    void popBack();
+
+    void resize(size_t capacity);
+
+    void swap(SmallVector<T, N, Policy> &other);
+
+private:
+    // MARK: big 6 helpers -d
+    void free();
+
+    void copyFrom(const SmallVector<T, N, Policy> &other);
+
+    void moveFrom(SmallVector<T, N, Policy> &&other);
+
+    // MARK: storage helpers -d
+    pointer inlineData() noexcept;
+
+    void destroy(size_type from, size_type to) noexcept;
+
+    void reallocate(size_type capacity);
+
+    void grow();
+
+    size_type grownCapacity(size_type required) const;
+
+    void relocateWithin(size_type first, size_type last, size_type dest);
+
+    void openGap(size_type idx, size_type count);
+
+    iterator insertAt(size_type idx, T &&value);
+};
+
+namespace kstd {
+    // the inline buffer makes the object refer to itself
+    template<class T, size_t N, class Policy>
+    struct is_trivially_relocatable<SmallVector<T, N, Policy>> : std::false_type {};
+}
+
+// MARK: big 6 -i
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector() : SmallVector<T, N, Policy>(defaultResource()) {}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(MemoryResource *resource)
+        : data_{inlineData()}, size_{0}, capacity_{N}, resource_{resource} {}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(std::initializer_list<T> data, MemoryResource *resource)
+        : SmallVector<T, N, Policy>(data.size(), resource) {
+    for (auto el = data.begin(); el != data.end(); ++el) {
+        new(&data_[size_]) T(*el);
+        size_++;
+    }
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(size_t capacity, MemoryResource *resource) : SmallVector<T, N, Policy>(resource) {
+    reserve(capacity);
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(const SmallVector<T, N, Policy> &other) : SmallVector<T, N, Policy>(other, defaultResource()) {}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(const SmallVector<T, N, Policy> &other, MemoryResource *resource)
+        : SmallVector<T, N, Policy>(resource) {
+    copyFrom(other);
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::SmallVector(SmallVector<T, N, Policy> &&other) noexcept : SmallVector<T, N, Policy>(other.resource_) {
+    moveFrom(std::move(other));
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy> &SmallVector<T, N, Policy>::operator=(const SmallVector<T, N, Policy> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy> &SmallVector<T, N, Policy>::operator=(SmallVector<T, N, Policy> &&other) noexcept {
+    if (this != &other) {
+        free();
+        resource_ = other.resource_;
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T, size_t N, class Policy>
+SmallVector<T, N, Policy>::~SmallVector() {
+    free();
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::assign(size_type count, const T &value) {
+    // value may refer to an element, so it is copied before the elements are cleared
+    T temp(value);
+    clear();
+    reserve(count);
+
+    for (; size_ < count; ++size_) {
+        new(&data_[size_]) T(temp);
+    }
+}
+
+template<class T, size_t N, class Policy>
+template<class InputIt>
+void SmallVector<T, N, Policy>::assign(InputIt first, InputIt last) {
+    clear();
+    if constexpr (!kstd::is_forward_iterator_v<InputIt>) {
+        for (; first != last; ++first) {
+            emplaceBack(*first);
+        }
+    } else {
+        reserve(std::distance(first, last));
+
+        for (auto it = first; it != last; ++it) {
+            new(&data_[size_]) T(*it);
+            size_++;
+        }
+    }
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::assign(std::initializer_list<value_type> data) {
+    assign(data.begin(), data.end());
+}
+
+template<class T, size_t N, class Policy>
+MemoryResource *SmallVector<T, N, Policy>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: element access -i
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_reference SmallVector<T, N, Policy>::at(size_t idx) const {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return data_[idx];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::reference SmallVector<T, N, Policy>::at(size_t idx) {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return data_[idx];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_reference SmallVector<T, N, Policy>::operator[](size_t idx) const {
+    return data_[idx];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::reference SmallVector<T, N, Policy>::operator[](size_t idx) {
+    return data_[idx];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_reference SmallVector<T, N, Policy>::front() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data_[0];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::reference SmallVector<T, N, Policy>::front() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data_[0];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_reference SmallVector<T, N, Policy>::back() const {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data_[size_ - 1];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::reference SmallVector<T, N, Policy>::back() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    return data_[size_ - 1];
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_pointer SmallVector<T, N, Policy>::data() const noexcept {
+    return data_;
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::pointer SmallVector<T, N, Policy>::data() noexcept {
+    return data_;
+}
+
+// MARK: iterators -i
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_iterator SmallVector<T, N, Policy>::begin() const noexcept {
+    return const_iterator(data_);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::begin() noexcept {
+    return iterator(data_);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_iterator SmallVector<T, N, Policy>::cbegin() const noexcept {
+    return const_iterator(data_);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_iterator SmallVector<T, N, Policy>::end() const noexcept {
+    return const_iterator(data_ + size_);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::end() noexcept {
+    return iterator(data_ + size_);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::const_iterator SmallVector<T, N, Policy>::cend() const noexcept {
+    return const_iterator(data_ + size_);
+}
+
+// MARK: capacity -i
+template<class T, size_t N, class Policy>
+bool SmallVector<T, N, Policy>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::size_type SmallVector<T, N, Policy>::size() const noexcept {
+    return size_;
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::size_type SmallVector<T, N, Policy>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<class T, size_t N, class Policy>
+bool SmallVector<T, N, Policy>::isSmall() const noexcept {
+    return data_ == reinterpret_cast<const_pointer>(buffer_);
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::reserve(size_type capacity) {
+    if (capacity > capacity_) {
+        reallocate(capacity);
+    }
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::shrinkToFit() {
+    if (capacity_ > size_ && !isSmall()) {
+        reallocate(size_);
+    }
+}
+
+// MARK: modifiers -i
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::clear() noexcept {
+    destroy(0, size_);
+    size_ = 0;
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insert(SmallVector::const_iterator pos, const T &value) {
+    return insertAt(pos - cbegin(), T(value));
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insert(SmallVector::const_iterator pos, T &&value) {
+    return insertAt(pos - cbegin(), std::move(value));
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insert(SmallVector::const_iterator pos, size_t count, const T &value) {
+    size_type idx = pos - cbegin();
+    // value may refer to an element, so it is copied before the gap is opened
+    T temp(value);
+    openGap(idx, count);
+
+    for (size_type i = idx; i < idx + count; ++i) {
+        new(&data_[i]) T(temp);
+    }
+    size_ += count;
+    return begin() + idx;
+}
+
+template<class T, size_t N, class Policy>
+template<class InputIt, class>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insert(SmallVector::const_iterator pos, InputIt first, InputIt last) {
+    size_type idx = pos - cbegin();
+    if constexpr (!kstd::is_forward_iterator_v<InputIt>) {
+        // a single pass range cannot be measured, so it is read into a buffer first
+        SmallVector<T, N, Policy> buffer(resource_);
+        for (; first != last; ++first) {
+            buffer.emplaceBack(*first);
+        }
+        return insert(cbegin() + idx, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+    } else {
+        size_type count = std::distance(first, last);
+        openGap(idx, count);
+
+        size_type i = idx;
+        for (auto it = first; it != last; ++it) {
+            new(&data_[i++]) T(*it);
+        }
+        size_ += count;
+        return begin() + idx;
+    }
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insert(SmallVector::const_iterator pos, std::initializer_list<T> ilist) {
+    return insert(pos, ilist.begin(), ilist.end());
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::erase(SmallVector::const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::erase(SmallVector::const_iterator first, SmallVector::const_iterator last) {
+    size_type from = first - cbegin();
+    size_type to = last - cbegin();
+
+    destroy(from, to);
+    relocateWithin(to, size_, from);
+    size_ -= to - from;
+    return begin() + from;
+}
+
+template<class T, size_t N, class Policy>
+template<class UnaryPredicate>
+typename SmallVector<T, N, Policy>::size_type SmallVector<T, N, Policy>::eraseIf(UnaryPredicate p) {
+    // the same single pass as Vector::eraseIf
+    size_type kept = 0;
+    size_type run = 0;
+    for (size_type i = 0; i < size_; ++i) {
+        if (p(data_[i])) {
+            relocateWithin(run, i, kept);
+            kept += i - run;
+            destroy(i, i + 1);
+            run = i + 1;
+        }
+    }
+    relocateWithin(run, size_, kept);
+    kept += size_ - run;
+
+    size_type removed = size_ - kept;
+    size_ = kept;
+    return removed;
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::pushBack(const T &value) {
+    emplaceBack(value);
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::pushBack(T &&value) {
+    emplaceBack(std::move(value));
+}
+
+template<class T, size_t N, class Policy>
+template<class... Args>
+typename SmallVector<T, N, Policy>::reference SmallVector<T, N, Policy>::emplaceBack(Args &&... args) {
+    if (size_ == capacity_) {
+        // args may refer to an element, so it is built before the reallocation
+        T temp(std::forward<Args>(args)...);
+        grow();
+        new(&data_[size_]) T(std::move(temp));
+    } else {
+        new(&data_[size_]) T(std::forward<Args>(args)...);
+    }
+    return data_[size_++];
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::popBack() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    destroy(size_ - 1, size_);
+    size_--;
+
+    size_type capacity = Policy::shrink(capacity_, size_);
+    if (!isSmall() && capacity < capacity_) {
+        reallocate(capacity);
+    }
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::resize(size_t capacity) {
+    reallocate(capacity);
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::swap(SmallVector<T, N, Policy> &other) {
+    if (!isSmall() && !other.isSmall()) {
+        kstd::swap(capacity_, other.capacity_);
+        kstd::swap(size_, other.size_);
+        kstd::swap(data_, other.data_);
+        kstd::swap(resource_, other.resource_);
+        return;
+    }
+
+    SmallVector<T, N, Policy> temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+// MARK: big 6 helpers -i
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::free() {
+    destroy(0, size_);
+    if (!isSmall()) {
+        kstd::deallocate(resource_, data_, capacity_);
+    }
+    data_ = inlineData();
+    size_ = 0;
+    capacity_ = N;
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::copyFrom(const SmallVector<T, N, Policy> &other) {
+    reserve(other.size_);
+
+    for (; size_ < other.size_; ++size_) {
+        new(&data_[size_]) T(other.data_[size_]);
+    }
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::moveFrom(SmallVector<T, N, Policy> &&other) {
+    // inline elements cannot be adopted, they are relocated into the inline buffer
+    if (other.isSmall()) {
+        reserve(other.size_);
+        kstd::relocate(other.data_, other.data_ + other.size_, data_);
+        size_ = other.size_;
+        other.size_ = 0;
+        other.free();
+        return;
+    }
+
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    data_ = other.data_;
+
+    other.data_ = other.inlineData();
+    other.size_ = 0;
+    other.capacity_ = N;
+}
+
+// MARK: storage helpers -i
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::pointer SmallVector<T, N, Policy>::inlineData() noexcept {
+    return reinterpret_cast<pointer>(buffer_);
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::destroy(size_type from, size_type to) noexcept {
+    kstd::destroy(data_ + from, data_ + to);
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::reallocate(size_type capacity) {
+    if (capacity < size_) {
+        destroy(capacity, size_);
+        size_ = capacity;
+    }
+
+    if (capacity <= N) {
+        if (!isSmall()) {
+            kstd::relocate(data_, data_ + size_, inlineData());
+            kstd::deallocate(resource_, data_, capacity_);
+            data_ = inlineData();
+        }
+        capacity_ = N;
+        return;
+    }
+
+    if (isSmall()) {
+        pointer heap = kstd::allocate<T>(resource_, capacity);
+        kstd::relocate(data_, data_ + size_, heap);
+        data_ = heap;
+    } else {
+        data_ = kstd::reallocate(resource_, data_, size_, capacity_, capacity);
+    }
+    capacity_ = capacity;
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::grow() {
+    reallocate(grownCapacity(size_ + 1));
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::size_type SmallVector<T, N, Policy>::grownCapacity(size_type required) const {
+    return Policy::grow(capacity_, required, sizeof(T));
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::relocateWithin(size_type first, size_type last, size_type dest) {
+    if (first == dest) {
+        return;
+    }
+
+    if constexpr (kstd::is_trivially_relocatable_v<T>) {
+        kstd::relocateOverlapping(data_ + first, data_ + last, data_ + dest);
+    } else if (dest < first) {
+        for (size_type i = first; i < last; ++i) {
+            new(&data_[dest + (i - first)]) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+    } else {
+        for (size_type i = last; i > first; --i) {
+            new(&data_[dest + (i - 1 - first)]) T(std::move(data_[i - 1]));
+            data_[i - 1].~T();
+        }
+    }
+}
+
+template<class T, size_t N, class Policy>
+void SmallVector<T, N, Policy>::openGap(size_type idx, size_type count) {
+    // leaves [idx, idx + count) as raw memory, size_ is not changed
+    if (size_ + count <= capacity_) {
+        relocateWithin(idx, size_, idx + count);
+        return;
+    }
+
+    size_type capacity = grownCapacity(size_ + count);
+
+    pointer heap = kstd::allocate<T>(resource_, capacity);
+    kstd::relocate(data_, data_ + idx, heap);
+    kstd::relocate(data_ + idx, data_ + size_, heap + idx + count);
+
+    if (!isSmall()) {
+        kstd::deallocate(resource_, data_, capacity_);
+    }
+    data_ = heap;
+    capacity_ = capacity;
+}
+
+template<class T, size_t N, class Policy>
+typename SmallVector<T, N, Policy>::iterator SmallVector<T, N, Policy>::insertAt(size_type idx, T &&value) {
+    // value may refer to an element, so it is taken out before the gap is opened
+    T temp(std::move(value));
+    openGap(idx, 1);
+
+    new(&data_[idx]) T(std::move(temp));
+    size_++;
+    return begin() + idx;
+}
@@ -0,0 +1,590 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "../Algorithm/Algorithm.hpp"
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../Pair/Pair.hpp"
+#include "../Span/Span.hpp"
+
+/*
+ * structure of arrays
+ *
+ * SoAVector<A, B, C> behaves like a vector of records {A, B, C}
+ * but keeps every field in its own contiguous array,
+ * a scan over one column only reads that column
+ *
+ * column<I>() is a Span over the I-th array,
+ * indexing and iterating gives SoARow proxies that refer to the fields of a row
+ * a two column row looks like a Pair of references (first / second)
+ */
+template<class... Ts>
+struct SoARow {
+    std::tuple<Ts &...> fields;
+
+    explicit SoARow(Ts &... fields) : fields(fields...) {}
+
+    template<size_t I>
+    auto &get() const {
+        return std::get<I>(fields);
+    }
+};
+
+template<class A, class B>
+struct SoARow<A, B> {
+    A &first;
+    B &second;
+
+    SoARow(A &first, B &second) : first(first), second(second) {}
+
+    template<size_t I>
+    auto &get() const {
+        if constexpr (I == 0) {
+            return first;
+        } else {
+            static_assert(I == 1, "a pair row has two fields");
+            return second;
+        }
+    }
+
+    operator Pair<std::remove_const_t<A>, std::remove_const_t<B>>() const {
+        return {first, second};
+    }
+};
+
+template<class Owner, class Row>
+class SoARowIterator {
+public:
+    typedef Row value_type;
+    typedef Row reference;
+    typedef void pointer;
+    typedef ptrdiff_t difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+
+private:
+    Owner *owner;
+    size_t idx;
+
+public:
+    SoARowIterator(Owner *owner = nullptr, size_t idx = 0) : owner{owner}, idx{idx} {}
+
+    reference operator*() const {
+        return (*owner)[idx];
+    }
+
+    reference operator[](difference_type d) const {
+        return (*owner)[idx + d];
+    }
+
+    SoARowIterator &operator++() {
+        ++idx;
+        return *this;
+    }
+
+    SoARowIterator operator++(int) {
+        SoARowIterator temp(*this);
+        ++idx;
+        return temp;
+    }
+
+    SoARowIterator &operator--() {
+        --idx;
+        return *this;
+    }
+
+    SoARowIterator operator--(int) {
+        SoARowIterator temp(*this);
+        --idx;
+        return temp;
+    }
+
+    SoARowIterator &operator+=(difference_type d) {
+        idx += d;
+        return *this;
+    }
+
+    SoARowIterator &operator-=(difference_type d) {
+        idx -= d;
+        return *this;
+    }
+
+    SoARowIterator operator+(difference_type d) const {
+        return SoARowIterator(owner, idx + d);
+    }
+
+    friend SoARowIterator operator+(difference_type d, const SoARowIterator &it) {
+        return it + d;
+    }
+
+    SoARowIterator operator-(difference_type d) const {
+        return SoARowIterator(owner, idx - d);
+    }
+
+    difference_type operator-(const SoARowIterator &other) const {
+        return difference_type(idx) - difference_type(other.idx);
+    }
+
+    size_t index() const {
+        return idx;
+    }
+
+    bool operator==(const SoARowIterator &other) const {
+        return idx == other.idx;
+    }
+
+    bool operator!=(const SoARowIterator &other) const {
+        return idx != other.idx;
+    }
+
+    bool operator<(const SoARowIterator &other) const {
+        return idx < other.idx;
+    }
+
+    bool operator>(const SoARowIterator &other) const {
+        return idx > other.idx;
+    }
+
+    bool operator<=(const SoARowIterator &other) const {
+        return idx <= other.idx;
+    }
+
+    bool operator>=(const SoARowIterator &other) const {
+        return idx >= other.idx;
+    }
+};
+
+template<class... Ts>
+class SoAVector {
+    static_assert(sizeof...(Ts) > 0, "a structure of arrays needs at least one column");
+public:
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef SoARow<Ts...> row;
+    typedef SoARow<const Ts...> const_row;
+    typedef SoARowIterator<SoAVector<Ts...>, row> iterator;
+    typedef SoARowIterator<const SoAVector<Ts...>, const_row> const_iterator;
+
+    template<size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    static const size_type COLUMNS = sizeof...(Ts);
+
+private:
+    std::tuple<Ts *...> columns;
+    size_type size_;
+    size_type capacity_;
+    MemoryResource *resource_;
+
+    static const short INITIAL_CAPACITY = 2;
+public:
+    // MARK: big 6 -d
+    SoAVector();
+
+    explicit SoAVector(MemoryResource *resource);
+
+    explicit SoAVector(size_type capacity, MemoryResource *resource = defaultResource());
+
+    SoAVector(const SoAVector<Ts...> &other);
+
+    SoAVector(const SoAVector<Ts...> &other, MemoryResource *resource);
+
+    SoAVector(SoAVector<Ts...> &&other) noexcept;
+
+    SoAVector<Ts...> &operator=(const SoAVector<Ts...> &other);
+
+    SoAVector<Ts...> &operator=(SoAVector<Ts...> &&other) noexcept;
+
+    ~SoAVector();
+
+    MemoryResource *resource() const noexcept;
+
+    // MARK: element access -d
+    const_row at(size_type idx) const;
+
+    row at(size_type idx);
+
+    const_row operator[](size_type idx) const;
+
+    row operator[](size_type idx);
+
+    template<size_t I>
+    Span<const column_type<I>> column() const noexcept;
+
+    template<size_t I>
+    Span<column_type<I>> column() noexcept;
+
+    // MARK: iterators -d
+    const_iterator begin() const noexcept;
+
+    iterator begin() noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator cend() const noexcept;
+
+    // MARK: capacity -d
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    void reserve(size_type capacity);
+
+    void shrinkToFit();
+
+    // MARK: modifiers -d
+    void clear() noexcept;
+
+    template<class... Args>
+    void pushBack(Args &&... values);
+
+    void popBack();
+
+    void swap(SoAVector<Ts...> &other);
+
+private:
+    // MARK: big 6 helpers -d
+    void free();
+
+    void copyFrom(const SoAVector<Ts...> &other);
+
+    void moveFrom(SoAVector<Ts...> &&other);
+
+    // MARK: storage helpers -d
+    void destroy(size_type from, size_type to) noexcept;
+
+    void reallocate(size_type capacity);
+
+    template<size_t... Is, class... Args>
+    void construct(std::index_sequence<Is...>, size_type idx, Args &&... values);
+
+    template<size_t... Is>
+    void copyRow(std::index_sequence<Is...>, const SoAVector<Ts...> &other);
+
+    template<size_t... Is>
+    void relocateFrom(std::index_sequence<Is...>, SoAVector<Ts...> &other);
+
+    // moves every column into target and frees the old ones
+    template<size_t... Is>
+    void relocateTo(std::index_sequence<Is...>, std::tuple<Ts *...> &target);
+
+    template<size_t... Is>
+    row rowAt(std::index_sequence<Is...>, size_type idx);
+
+    template<size_t... Is>
+    const_row rowAt(std::index_sequence<Is...>, size_type idx) const;
+};
+
+namespace kstd {
+    template<class... Ts>
+    struct is_trivially_relocatable<SoAVector<Ts...>> : std::true_type {};
+}
+
+// MARK: big 6 -i
+template<class... Ts>
+SoAVector<Ts...>::SoAVector() : SoAVector<Ts...>(defaultResource()) {}
+
+template<class... Ts>
+SoAVector<Ts...>::SoAVector(MemoryResource *resource)
+        : columns{}, size_{0}, capacity_{0}, resource_{resource} {}
+
+template<class... Ts>
+SoAVector<Ts...>::SoAVector(size_type capacity, MemoryResource *resource) : SoAVector<Ts...>(resource) {
+    reserve(capacity);
+}
+
+template<class... Ts>
+SoAVector<Ts...>::SoAVector(const SoAVector<Ts...> &other) : SoAVector<Ts...>(other, defaultResource()) {}
+
+template<class... Ts>
+SoAVector<Ts...>::SoAVector(const SoAVector<Ts...> &other, MemoryResource *resource) : SoAVector<Ts...>(resource) {
+    copyFrom(other);
+}
+
+template<class... Ts>
+SoAVector<Ts...>::SoAVector(SoAVector<Ts...> &&other) noexcept : SoAVector<Ts...>(other.resource_) {
+    moveFrom(std::move(other));
+}
+
+template<class... Ts>
+SoAVector<Ts...> &SoAVector<Ts...>::operator=(const SoAVector<Ts...> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class... Ts>
+SoAVector<Ts...> &SoAVector<Ts...>::operator=(SoAVector<Ts...> &&other) noexcept {
+    if (this != &other) {
+        free();
+        resource_ = other.resource_;
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class... Ts>
+SoAVector<Ts...>::~SoAVector() {
+    free();
+}
+
+template<class... Ts>
+MemoryResource *SoAVector<Ts...>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: element access -i
+template<class... Ts>
+typename SoAVector<Ts...>::const_row SoAVector<Ts...>::at(size_type idx) const {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::row SoAVector<Ts...>::at(size_type idx) {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return operator[](idx);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::const_row SoAVector<Ts...>::operator[](size_type idx) const {
+    return rowAt(std::index_sequence_for<Ts...>{}, idx);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::row SoAVector<Ts...>::operator[](size_type idx) {
+    return rowAt(std::index_sequence_for<Ts...>{}, idx);
+}
+
+template<class... Ts>
+template<size_t I>
+Span<const typename SoAVector<Ts...>::template column_type<I>> SoAVector<Ts...>::column() const noexcept {
+    return Span<const column_type<I>>(std::get<I>(columns), size_);
+}
+
+template<class... Ts>
+template<size_t I>
+Span<typename SoAVector<Ts...>::template column_type<I>> SoAVector<Ts...>::column() noexcept {
+    return Span<column_type<I>>(std::get<I>(columns), size_);
+}
+
+// MARK: iterators -i
+template<class... Ts>
+typename SoAVector<Ts...>::const_iterator SoAVector<Ts...>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::iterator SoAVector<Ts...>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::const_iterator SoAVector<Ts...>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::const_iterator SoAVector<Ts...>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::iterator SoAVector<Ts...>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::const_iterator SoAVector<Ts...>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+// MARK: capacity -i
+template<class... Ts>
+bool SoAVector<Ts...>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::size_type SoAVector<Ts...>::size() const noexcept {
+    return size_;
+}
+
+template<class... Ts>
+typename SoAVector<Ts...>::size_type SoAVector<Ts...>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::reserve(size_type capacity) {
+    if (capacity > capacity_) {
+        reallocate(capacity);
+    }
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::shrinkToFit() {
+    if (capacity_ > size_) {
+        reallocate(size_);
+    }
+}
+
+// MARK: modifiers -i
+template<class... Ts>
+void SoAVector<Ts...>::clear() noexcept {
+    destroy(0, size_);
+    size_ = 0;
+}
+
+template<class... Ts>
+template<class... Args>
+void SoAVector<Ts...>::pushBack(Args &&... values) {
+    static_assert(sizeof...(Args) == sizeof...(Ts), "a row needs one value per column");
+
+    if (size_ == capacity_) {
+        // values may refer to a row, so they are taken out before the reallocation
+        std::tuple<Ts...> row(std::forward<Args>(values)...);
+        reallocate(capacity_ == 0 ? INITIAL_CAPACITY : 2 * capacity_);
+        std::apply([this](Ts &... fields) {
+            construct(std::index_sequence_for<Ts...>{}, size_, std::move(fields)...);
+        }, row);
+    } else {
+        construct(std::index_sequence_for<Ts...>{}, size_, std::forward<Args>(values)...);
+    }
+    size_++;
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::popBack() {
+    if (empty()) {
+        throw std::length_error("vector is empty!");
+    }
+    destroy(size_ - 1, size_);
+    size_--;
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::swap(SoAVector<Ts...> &other) {
+    kstd::swap(columns, other.columns);
+    kstd::swap(size_, other.size_);
+    kstd::swap(capacity_, other.capacity_);
+    kstd::swap(resource_, other.resource_);
+}
+
+// MARK: big 6 helpers -i
+template<class... Ts>
+void SoAVector<Ts...>::free() {
+    destroy(0, size_);
+    std::apply([this](auto *&... column) {
+        (kstd::deallocate(resource_, column, capacity_), ...);
+        ((column = nullptr), ...);
+    }, columns);
+    size_ = capacity_ = 0;
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::copyFrom(const SoAVector<Ts...> &other) {
+    reserve(other.size_);
+    for (; size_ < other.size_; ++size_) {
+        copyRow(std::index_sequence_for<Ts...>{}, other);
+    }
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::moveFrom(SoAVector<Ts...> &&other) {
+    columns = other.columns;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+
+    other.columns = {};
+    other.size_ = other.capacity_ = 0;
+}
+
+// MARK: storage helpers -i
+template<class... Ts>
+void SoAVector<Ts...>::destroy(size_type from, size_type to) noexcept {
+    std::apply([from, to](auto *... column) {
+        (kstd::destroy(column + from, column + to), ...);
+    }, columns);
+}
+
+template<class... Ts>
+void SoAVector<Ts...>::reallocate(size_type capacity) {
+    // every column is allocated before anything moves,
+    // so a failed allocation leaves the vector as it was
+    std::tuple<Ts *...> newColumns{};
+    try {
+        std::apply([this, capacity](auto *&... column) {
+            ((column = kstd::allocate<std::remove_reference_t<decltype(*column)>>(resource_, capacity)), ...);
+        }, newColumns);
+    } catch (...) {
+        std::apply([this, capacity](auto *... column) {
+            (kstd::deallocate(resource_, column, capacity), ...);
+        }, newColumns);
+        throw;
+    }
+
+    if (capacity < size_) {
+        destroy(capacity, size_);
+        size_ = capacity;
+    }
+
+    relocateTo(std::index_sequence_for<Ts...>{}, newColumns);
+    columns = newColumns;
+    capacity_ = capacity;
+}
+
+template<class... Ts>
+template<size_t... Is, class... Args>
+void SoAVector<Ts...>::construct(std::index_sequence<Is...>, size_type idx, Args &&... values) {
+    (new(std::get<Is>(columns) + idx) Ts(std::forward<Args>(values)), ...);
+}
+
+template<class... Ts>
+template<size_t... Is>
+void SoAVector<Ts...>::copyRow(std::index_sequence<Is...>, const SoAVector<Ts...> &other) {
+    construct(std::index_sequence<Is...>{}, size_, std::get<Is>(other.columns)[size_]...);
+}
+
+template<class... Ts>
+template<size_t... Is>
+void SoAVector<Ts...>::relocateFrom(std::index_sequence<Is...>, SoAVector<Ts...> &other) {
+    (kstd::relocate(std::get<Is>(other.columns), std::get<Is>(other.columns) + other.size_,
+                    std::get<Is>(columns)), ...);
+}
+
+template<class... Ts>
+template<size_t... Is>
+void SoAVector<Ts...>::relocateTo(std::index_sequence<Is...>, std::tuple<Ts *...> &target) {
+    (kstd::relocate(std::get<Is>(columns), std::get<Is>(columns) + size_, std::get<Is>(target)), ...);
+    (kstd::deallocate(resource_, std::get<Is>(columns), capacity_), ...);
+}
+
+template<class... Ts>
+template<size_t... Is>
+typename SoAVector<Ts...>::row SoAVector<Ts...>::rowAt(std::index_sequence<Is...>, size_type idx) {
+    return row(std::get<Is>(columns)[idx]...);
+}
+
+template<class... Ts>
+template<size_t... Is>
+typename SoAVector<Ts...>::const_row SoAVector<Ts...>::rowAt(std::index_sequence<Is...>, size_type idx) const {
+    return const_row(std::get<Is>(columns)[idx]...);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include "../ArrayIterator/ArrayIterator.hpp"
+
+// non owning view over a contiguous range of T
+template<class T>
+class Span {
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T *pointer;
+    typedef ArrayIterator<value_type> iterator;
+
+private:
+    pointer data_;
+    size_type size_;
+
+public:
+    Span();
+
+    Span(pointer data, size_type size);
+
+    Span(pointer first, pointer last);
+
+    reference operator[](size_type idx) const;
+
+    reference at(size_type idx) const;
+
+    pointer data() const noexcept;
+
+    iterator begin() const noexcept;
+
+    iterator end() const noexcept;
+
+    bool empty() const noexcept;
+
+    size_type size() const noexcept;
+
+    Span<T> subspan(size_type pos, size_type count) const;
+};
+
+template<class T>
+Span<T>::Span() : data_{nullptr}, size_{0} {}
+
+template<class T>
+Span<T>::Span(pointer data, size_type size) : data_{data}, size_{size} {}
+
+template<class T>
+Span<T>::Span(pointer first, pointer last) : data_{first}, size_(last - first) {}
+
+template<class T>
+typename Span<T>::reference Span<T>::operator[](size_type idx) const {
+    return data_[idx];
+}
+
+template<class T>
+typename Span<T>::reference Span<T>::at(size_type idx) const {
+    if (idx >= size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    return data_[idx];
+}
+
+template<class T>
+typename Span<T>::pointer Span<T>::data() const noexcept {
+    return data_;
+}
+
+template<class T>
+typename Span<T>::iterator Span<T>::begin() const noexcept {
+    return iterator(data_);
+}
+
+template<class T>
+typename Span<T>::iterator Span<T>::end() const noexcept {
+    return iterator(data_ + size_);
+}
+
+template<class T>
+bool Span<T>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class T>
+typename Span<T>::size_type Span<T>::size() const noexcept {
+    return size_;
+}
+
+template<class T>
+Span<T> Span<T>::subspan(size_type pos, size_type count) const {
+    if (pos > size_) {
+        throw std::out_of_range("index is out of range!");
+    }
+    if (count > size_ - pos) {
+        count = size_ - pos;
+    }
+    return Span<T>(data_ + pos, count);
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+
+/*
+ * bounded lock-free queue for exactly one producer and one consumer thread
+ *
+ * same ring as Queue, but the capacity is fixed and rounded up to a power of two,
+ * put and get only ever grow and the slot is found with idx & mask
+ *
+ * each index lives on its own cache line next to a cached copy of the other index,
+ * so a thread only touches the other side's line when the ring looks full or empty
+ *
+ * only the producer may call tryPush / tryEmplace,
+ * only the consumer may call tryPop / peek
+ */
+template<class T>
+class SpscQueue {
+private:
+    // written by the producer
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<size_t> put;
+    size_t cachedGet;
+
+    // written by the consumer
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<size_t> get;
+    size_t cachedPut;
+
+    // read only after construction
+    alignas(kstd::CACHE_LINE_SIZE) T *data;
+    size_t mask;
+    MemoryResource *resource_;
+
+public:
+    explicit SpscQueue(size_t capacity, MemoryResource *resource = defaultResource());
+
+    SpscQueue(const SpscQueue<T> &other) = delete;
+
+    SpscQueue<T> &operator=(const SpscQueue<T> &other) = delete;
+
+    ~SpscQueue();
+
+    // MARK: producer -d
+    bool tryPush(const T &element);
+
+    bool tryPush(T &&element);
+
+    template<class... Args>
+    bool tryEmplace(Args &&... args);
+
+    // MARK: consumer -d
+    bool tryPop(T &element);
+
+    // the front element or nullptr when the queue is empty,
+    // it stays valid until the consumer pops it
+    T *peek();
+
+    void pop();
+
+    // MARK: capacity -d
+    // exact only when neither thread is running
+    bool empty() const noexcept;
+
+    size_t size() const noexcept;
+
+    size_t capacity() const noexcept;
+
+    MemoryResource *resource() const noexcept;
+};
+
+template<class T>
+SpscQueue<T>::SpscQueue(size_t capacity, MemoryResource *resource)
+        : put{0}, cachedGet{0}, get{0}, cachedPut{0}, resource_{resource} {
+    if (capacity == 0) {
+        throw std::length_error("capacity must be positive!");
+    }
+    capacity = kstd::ceilPowerOfTwo(capacity);
+    data = kstd::allocate<T>(resource_, capacity);
+    mask = capacity - 1;
+}
+
+template<class T>
+SpscQueue<T>::~SpscQueue() {
+    size_t end = put.load(std::memory_order_relaxed);
+    for (size_t idx = get.load(std::memory_order_relaxed); idx != end; ++idx) {
+        data[idx & mask].~T();
+    }
+    kstd::deallocate(resource_, data, mask + 1);
+}
+
+// MARK: producer -i
+template<class T>
+bool SpscQueue<T>::tryPush(const T &element) {
+    return tryEmplace(element);
+}
+
+template<class T>
+bool SpscQueue<T>::tryPush(T &&element) {
+    return tryEmplace(std::move(element));
+}
+
+template<class T>
+template<class... Args>
+bool SpscQueue<T>::tryEmplace(Args &&... args) {
+    size_t idx = put.load(std::memory_order_relaxed);
+    if (idx - cachedGet > mask) {
+        cachedGet = get.load(std::memory_order_acquire);
+        if (idx - cachedGet > mask) {
+            return false;
+        }
+    }
+
+    new(data + (idx & mask)) T(std::forward<Args>(args)...);
+    put.store(idx + 1, std::memory_order_release);
+    return true;
+}
+
+// MARK: consumer -i
+template<class T>
+bool SpscQueue<T>::tryPop(T &element) {
+    T *front = peek();
+    if (!front) {
+        return false;
+    }
+    element = std::move(*front);
+    pop();
+    return true;
+}
+
+template<class T>
+T *SpscQueue<T>::peek() {
+    size_t idx = get.load(std::memory_order_relaxed);
+    if (idx == cachedPut) {
+        cachedPut = put.load(std::memory_order_acquire);
+        if (idx == cachedPut) {
+            return nullptr;
+        }
+    }
+    return data + (idx & mask);
+}
+
+template<class T>
+void SpscQueue<T>::pop() {
+    if (!peek()) {
+        throw std::length_error("queue is empty!");
+    }
+    size_t idx = get.load(std::memory_order_relaxed);
+    data[idx & mask].~T();
+    get.store(idx + 1, std::memory_order_release);
+}
+
+// MARK: capacity -i
+template<class T>
+bool SpscQueue<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<class T>
+size_t SpscQueue<T>::size() const noexcept {
+    size_t idx = get.load(std::memory_order_acquire);
+    return put.load(std::memory_order_acquire) - idx;
+}
+
+template<class T>
+size_t SpscQueue<T>::capacity() const noexcept {
+    return mask + 1;
+}
+
+template<class T>
+MemoryResource *SpscQueue<T>::resource() const noexcept {
+    return resource_;
+}
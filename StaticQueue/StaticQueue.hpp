@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "../Memory/Memory.hpp"
+#include "../TypeTraits/TypeTraits.hpp"
+
+/*
+ * Queue with a capacity fixed at compile time
+ *
+ * the N slots live inside the object, so it never allocates,
+ * put and get only ever grow and the slot is found with idx & (N - 1)
+ *
+ * a full queue rejects new elements, unless Overwrite is set,
+ * then pushing drops the oldest element instead (e.g. the last N samples of telemetry)
+ */
+template<class T, size_t N, bool Overwrite = false>
+class StaticQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity of a static queue must be a power of two");
+private:
+    size_t put;
+    size_t get;
+
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+
+    static const size_t MASK = N - 1;
+
+public:
+    StaticQueue();
+
+    StaticQueue(const StaticQueue<T, N, Overwrite> &other);
+
+    StaticQueue(StaticQueue<T, N, Overwrite> &&other) noexcept;
+
+    StaticQueue &operator=(const StaticQueue<T, N, Overwrite> &other);
+
+    StaticQueue &operator=(StaticQueue<T, N, Overwrite> &&other) noexcept;
+
+    ~StaticQueue();
+
+    bool empty() const noexcept;
+
+    bool full() const noexcept;
+
+    size_t size() const noexcept;
+
+    static constexpr size_t capacity() noexcept {
+        return N;
+    }
+
+    // throws when the queue is full and Overwrite is not set
+    void push(const T &element);
+
+    void push(T &&element);
+
+    template<class... Args>
+    void emplace(Args &&... args);
+
+    // returns false instead of throwing or overwriting when the queue is full
+    bool tryPush(const T &element);
+
+    bool tryPush(T &&element);
+
+    const T &peek() const;
+
+    T &peek();
+
+    void pop();
+
+    void clear() noexcept;
+
+private:
+    T *slot(size_t idx) noexcept;
+
+    const T *slot(size_t idx) const noexcept;
+
+    void free() noexcept;
+
+    void copyFrom(const StaticQueue<T, N, Overwrite> &other);
+
+    void moveFrom(StaticQueue<T, N, Overwrite> &&other);
+};
+
+namespace kstd {
+    template<class T, size_t N, bool Overwrite>
+    struct is_trivially_relocatable<StaticQueue<T, N, Overwrite>> : is_trivially_relocatable<T> {};
+}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite>::StaticQueue() : put{0}, get{0} {}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite>::StaticQueue(const StaticQueue<T, N, Overwrite> &other) : StaticQueue() {
+    copyFrom(other);
+}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite>::StaticQueue(StaticQueue<T, N, Overwrite> &&other) noexcept : StaticQueue() {
+    moveFrom(std::move(other));
+}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite> &StaticQueue<T, N, Overwrite>::operator=(const StaticQueue<T, N, Overwrite> &other) {
+    if (this != &other) {
+        free();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite> &StaticQueue<T, N, Overwrite>::operator=(StaticQueue<T, N, Overwrite> &&other) noexcept {
+    if (this != &other) {
+        free();
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+template<class T, size_t N, bool Overwrite>
+StaticQueue<T, N, Overwrite>::~StaticQueue() {
+    free();
+}
+
+template<class T, size_t N, bool Overwrite>
+bool StaticQueue<T, N, Overwrite>::empty() const noexcept {
+    return put == get;
+}
+
+template<class T, size_t N, bool Overwrite>
+bool StaticQueue<T, N, Overwrite>::full() const noexcept {
+    return put - get == N;
+}
+
+template<class T, size_t N, bool Overwrite>
+size_t StaticQueue<T, N, Overwrite>::size() const noexcept {
+    return put - get;
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::push(const T &element) {
+    emplace(element);
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::push(T &&element) {
+    emplace(std::move(element));
+}
+
+template<class T, size_t N, bool Overwrite>
+template<class... Args>
+void StaticQueue<T, N, Overwrite>::emplace(Args &&... args) {
+    if (full()) {
+        if constexpr (Overwrite) {
+            // the new element may be built from the oldest one
+            T temp(std::forward<Args>(args)...);
+            pop();
+            new(slot(put++)) T(std::move(temp));
+            return;
+        } else {
+            throw std::length_error("queue is full!");
+        }
+    }
+    new(slot(put)) T(std::forward<Args>(args)...);
+    put++;
+}
+
+template<class T, size_t N, bool Overwrite>
+bool StaticQueue<T, N, Overwrite>::tryPush(const T &element) {
+    if (full()) {
+        return false;
+    }
+    new(slot(put)) T(element);
+    put++;
+    return true;
+}
+
+template<class T, size_t N, bool Overwrite>
+bool StaticQueue<T, N, Overwrite>::tryPush(T &&element) {
+    if (full()) {
+        return false;
+    }
+    new(slot(put)) T(std::move(element));
+    put++;
+    return true;
+}
+
+template<class T, size_t N, bool Overwrite>
+const T &StaticQueue<T, N, Overwrite>::peek() const {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    return *slot(get);
+}
+
+template<class T, size_t N, bool Overwrite>
+T &StaticQueue<T, N, Overwrite>::peek() {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    return *slot(get);
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::pop() {
+    if (empty()) {
+        throw std::logic_error("queue is empty");
+    }
+    slot(get++)->~T();
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::clear() noexcept {
+    free();
+}
+
+template<class T, size_t N, bool Overwrite>
+T *StaticQueue<T, N, Overwrite>::slot(size_t idx) noexcept {
+    return reinterpret_cast<T *>(buffer_) + (idx & MASK);
+}
+
+template<class T, size_t N, bool Overwrite>
+const T *StaticQueue<T, N, Overwrite>::slot(size_t idx) const noexcept {
+    return reinterpret_cast<const T *>(buffer_) + (idx & MASK);
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::free() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (; get != put; ++get) {
+            slot(get)->~T();
+        }
+    }
+    put = get = 0;
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::copyFrom(const StaticQueue<T, N, Overwrite> &other) {
+    for (size_t idx = other.get; idx != other.put; ++idx) {
+        new(slot(put)) T(*other.slot(idx));
+        put++;
+    }
+}
+
+template<class T, size_t N, bool Overwrite>
+void StaticQueue<T, N, Overwrite>::moveFrom(StaticQueue<T, N, Overwrite> &&other) {
+    // the slots keep their positions, so the ring does not have to be unrolled
+    get = other.get & MASK;
+    put = get + other.size();
+    for (size_t idx = other.get; idx != other.put; ++idx) {
+        kstd::relocate(other.slot(idx), other.slot(idx) + 1, slot(idx));
+    }
+    other.put = other.get = 0;
+}
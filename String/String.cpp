@@ -2,10 +2,11 @@
 #include "String.h"
 #include "BitManipulation.h"
 
-String::String(size_t capacity) : data{} {
+String::String(size_t capacity, MemoryResource *resource) : data{}, resource_{resource} {
     if (capacity > ssoCapacity) {
-        dynamicStr() = new char[capacity + 1]{};
-        useDynamicStr(0, capacity + 1);
+        dynamicStr() = allocate(capacity);
+        memset(dynamicStr(), 0, capacity + 1);
+        useDynamicStr(0, capacity);
     } else {
         useOptimisation(0);
     }
@@ -13,11 +14,13 @@ String::String(size_t capacity) : data{} {
 
 String::String() : String("") {}
 
-String::String(const char *str) : data{} {
+String::String(const char *str, MemoryResource *resource) : data{}, resource_{resource} {
     setData(str);
 }
 
-String::String(const String &other) : data{} {
+String::String(const String &other) : String(other, defaultResource()) {}
+
+String::String(const String &other, MemoryResource *resource) : data{}, resource_{resource} {
     copyFrom(other);
 }
 
@@ -72,7 +75,7 @@ void String::setData(const char *str) {
     }
 
     free();
-    dynamicStr() = new char[len + ssoCapacity + 1];
+    dynamicStr() = allocate(len + ssoCapacity);
     strcpy(dynamicStr(), str);
     useDynamicStr(len, len + ssoCapacity);
 }
@@ -92,9 +95,15 @@ bool String::isOptimised() const {
     return !BitManipulation::leftmostBitIsSet(staticStr()[ssoCapacity]);
 }
 
+String::pointer String::allocate(size_t capacity) {
+    auto str = static_cast<pointer>(resource_->allocate(capacity + 1, alignof(char)));
+    str[0] = '\0';
+    return str;
+}
+
 void String::free() {
-    if (!isOptimised()) {
-        delete[] dynamicStr();
+    if (!isOptimised() && dynamicStr()) {
+        resource_->deallocate(dynamicStr(), capacity() + 1, alignof(char));
         dynamicStr() = nullptr;
     }
 }
@@ -104,12 +113,16 @@ void String::copyFrom(const String &other) {
         strcpy(staticStr(), other.c_str());
         useOptimisation(other.length());
     } else {
-        dynamicStr() = new char[other.capacity() + 1];
+        dynamicStr() = allocate(other.capacity());
         strcpy(dynamicStr(), other.c_str());
         useDynamicStr(other.length(), other.capacity());
     }
 }
 
+MemoryResource *String::resource() const {
+    return resource_;
+}
+
 String::size_type String::size() const {
     return length();
 }
@@ -235,7 +248,7 @@ String &String::operator+=(const String &other) {
         return *this;
     }
 
-    char *newData = new char[newLen + ssoCapacity + 1]{};
+    char *newData = allocate(newLen + ssoCapacity);
 
     strcat(newData, c_str());
     strcat(newData, other.c_str());
@@ -262,7 +275,7 @@ String &String::operator+=(char c) {
         return *this;
     }
 
-    char *newData = new char[newLen + ssoCapacity + 1];
+    char *newData = allocate(newLen + ssoCapacity);
     strcat(newData, c_str());
     newData[newLen - 1] = c;
     newData[newLen] = '\0';
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include "../ArrayIterator/ArrayIterator.hpp"
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
 /*
  * Small String Optimisation
@@ -21,6 +23,9 @@
  * by its complement to ssoCapacity meaning that
  * if the size is 23 the last char will be 23 - 23 = 0 or a null terminator
  *
+ * the dynamic char array is taken from a memory resource
+ * and always holds capacity + 1 chars
+ *
  */
 class String {
 public:
@@ -44,6 +49,8 @@ private:
         char staticStr[sizeof(dynamicStr)];
     } data;
 
+    MemoryResource *resource_;
+
     static const unsigned char ssoCapacity = sizeof(data.dynamicStr) - 1;
 
     // wrapper functions to call instead of
@@ -65,25 +72,31 @@ private:
     void useDynamicStr(size_t, size_t);
 
     // the usual helpers with the Big 4
+    pointer allocate(size_t capacity);
+
     void free();
 
     void copyFrom(const String &);
 
 public:
-    explicit String(size_t);
+    explicit String(size_t, MemoryResource * = defaultResource());
 
     String();
 
-    String(const char *);
+    String(const char *, MemoryResource * = defaultResource());
 
     String(const String &);
 
+    String(const String &, MemoryResource *);
+
     String &operator=(const String &);
 
     ~String();
 
     void setData(const char *);
 
+    MemoryResource *resource() const;
+
     size_type size() const;
     size_type length() const;
 
@@ -124,6 +137,12 @@ public:
     friend std::istream &operator>>(std::istream &, String &);
 };
 
+// neither the dynamic nor the static representation points into the object itself
+namespace kstd {
+    template<>
+    struct is_trivially_relocatable<String> : std::true_type {};
+}
+
 std::ostream &operator<<(std::ostream &, const String &);
 
 String operator+(const String &, const String &);
@@ -0,0 +1,175 @@
+#include "ThreadPool.h"
+
+namespace {
+    // the pool the calling thread works for, if any
+    thread_local const ThreadPool *currentPool = nullptr;
+    thread_local size_t currentIndex = 0;
+}
+
+TaskGroup::TaskGroup() : pending{0}, failed{false}, error{} {}
+
+bool TaskGroup::done() const noexcept {
+    return pending.load(std::memory_order_acquire) == 0;
+}
+
+ThreadPool::ThreadPool(size_t threads)
+        : injectedCount{0}, submitted{0}, sleeping{0}, stopping{false} {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) {
+            threads = 1;
+        }
+    }
+
+    // every deque has to exist before the first worker tries to steal from it
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.pushBack(UniquePtr<Worker>(new Worker()));
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (UniquePtr<Worker> &worker: workers) {
+        worker->thread.join();
+    }
+}
+
+size_t ThreadPool::size() const noexcept {
+    return workers.size();
+}
+
+ThreadPool &ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::wait(TaskGroup &group) {
+    size_t self = currentWorker();
+    while (!group.done()) {
+        Task *task = findTask(self);
+        if (task) {
+            execute(task);
+        } else if (self < size()) {
+            // a worker keeps looking, the tasks it waits for may need it
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(group.mutex);
+            group.finished.wait(lock, [&group]() { return group.done(); });
+        }
+    }
+    // waits for the last task to leave the group before the caller may destroy it
+    {
+        std::lock_guard<std::mutex> lock(group.mutex);
+    }
+
+    if (group.failed.load(std::memory_order_acquire)) {
+        std::exception_ptr error = group.error;
+        group.error = nullptr;
+        group.failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::enqueue(Task *task) {
+    size_t self = currentWorker();
+    if (self < size()) {
+        workers[self]->tasks.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        injected.push(task);
+        injectedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // a worker about to sleep either sees the new count or is counted in sleeping
+    submitted.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeUp.notify_one();
+    }
+}
+
+ThreadPool::Task *ThreadPool::findTask(size_t self) {
+    Task *task = nullptr;
+    if (self < size() && workers[self]->tasks.pop(task)) {
+        return task;
+    }
+
+    if (injectedCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!injected.empty()) {
+            task = injected.peek();
+            injected.pop();
+            injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    size_t count = size();
+    for (size_t i = 1; i <= count; ++i) {
+        size_t victim = (self + i) % count;
+        if (victim != self && workers[victim]->tasks.steal(task)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::execute(Task *task) noexcept {
+    TaskGroup *group = task->group;
+    try {
+        task->run();
+    } catch (...) {
+        // nobody can wait for a task without a group, so its exception ends the program
+        // like one escaping the function of a std::thread
+        if (!group) {
+            std::terminate();
+        }
+        if (!group->failed.exchange(true, std::memory_order_relaxed)) {
+            group->error = std::current_exception();
+        }
+    }
+    delete task;
+
+    if (group) {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        if (group->pending.fetch_sub(1, std::memory_order_release) == 1) {
+            group->finished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop(size_t self) {
+    currentPool = this;
+    currentIndex = self;
+
+    while (true) {
+        size_t seen = submitted.load(std::memory_order_seq_cst);
+        Task *task = findTask(self);
+        if (task) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping && injected.empty()) {
+            break;
+        }
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        wakeUp.wait(lock, [this, seen]() {
+            return stopping || submitted.load(std::memory_order_seq_cst) != seen;
+        });
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+size_t ThreadPool::currentWorker() const noexcept {
+    return currentPool == this ? currentIndex : size();
+}
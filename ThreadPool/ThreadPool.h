@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "../Queue/Queue.hpp"
+#include "../UniquePtr/UniquePtr.hpp"
+#include "../Vector/Vector.hpp"
+#include "../WorkStealingDeque/WorkStealingDeque.hpp"
+
+/*
+ * fork / join handle
+ *
+ * counts the tasks submitted with it that have not finished yet,
+ * ThreadPool::wait(group) runs other tasks until it reaches zero
+ * and rethrows the first exception one of them threw,
+ * a thread outside the pool that runs out of tasks sleeps until the last one finishes
+ *
+ * a group must outlive its tasks, so wait on it before it goes out of scope
+ */
+class TaskGroup {
+    friend class ThreadPool;
+
+    std::atomic<size_t> pending;
+    std::atomic<bool> failed;
+    std::exception_ptr error;
+
+    // pending only drops under the mutex, so a waiter that locks it after seeing zero
+    // knows the last task no longer touches the group
+    std::mutex mutex;
+    std::condition_variable finished;
+
+public:
+    TaskGroup();
+
+    TaskGroup(const TaskGroup &other) = delete;
+
+    TaskGroup &operator=(const TaskGroup &other) = delete;
+
+    bool done() const noexcept;
+};
+
+/*
+ * fixed size pool of worker threads with one work-stealing deque per worker
+ *
+ * a task submitted from a worker goes to the bottom of that worker's deque,
+ * one submitted from any other thread goes to a shared queue,
+ * an idle worker looks at its own deque, then the shared queue
+ * and then steals from the top of the others
+ *
+ * workers that find nothing go to sleep until the next submit
+ *
+ * waiting on a group from inside a task does not block the worker,
+ * it keeps running tasks, so nested parallelFor calls cannot deadlock
+ */
+class ThreadPool {
+private:
+    struct Task {
+        TaskGroup *group;
+
+        explicit Task(TaskGroup *group) : group{group} {}
+
+        virtual ~Task() = default;
+
+        virtual void run() = 0;
+    };
+
+    template<class F>
+    struct FunctionTask : Task {
+        F function;
+
+        FunctionTask(TaskGroup *group, F &&function) : Task(group), function(std::move(function)) {}
+
+        void run() override {
+            function();
+        }
+    };
+
+    struct alignas(kstd::CACHE_LINE_SIZE) Worker {
+        WorkStealingDeque<Task *> tasks;
+        std::thread thread;
+    };
+
+    Vector<UniquePtr<Worker>> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    Queue<Task *> injected;
+    std::atomic<size_t> injectedCount;
+    std::atomic<size_t> submitted;
+    std::atomic<size_t> sleeping;
+    bool stopping;
+
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+
+    ThreadPool(const ThreadPool &other) = delete;
+
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+
+    // runs the tasks that are still queued and joins the workers
+    ~ThreadPool();
+
+    size_t size() const noexcept;
+
+    // a pool shared by everything that does not bring its own
+    static ThreadPool &global();
+
+    // MARK: tasks -d
+    // fire and forget, an exception thrown by function calls std::terminate,
+    // submit it with a TaskGroup to get the exception back from wait
+    template<class F>
+    void submit(F &&function);
+
+    template<class F>
+    void submit(TaskGroup &group, F &&function);
+
+    void wait(TaskGroup &group);
+
+    // calls body(i) for every i in [first, last) in chunks of grain indices
+    // and returns when all of them are done, 0 picks the grain from the pool size
+    template<class F>
+    void parallelFor(size_t first, size_t last, F &&body, size_t grain = 0);
+
+private:
+    void enqueue(Task *task);
+
+    Task *findTask(size_t self);
+
+    void execute(Task *task) noexcept;
+
+    void workerLoop(size_t self);
+
+    // index of the calling thread in this pool, or size() when it is not a worker
+    size_t currentWorker() const noexcept;
+};
+
+// MARK: tasks -i
+template<class F>
+void ThreadPool::submit(F &&function) {
+    typedef std::decay_t<F> Function;
+    enqueue(new FunctionTask<Function>(nullptr, Function(std::forward<F>(function))));
+}
+
+template<class F>
+void ThreadPool::submit(TaskGroup &group, F &&function) {
+    typedef std::decay_t<F> Function;
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    enqueue(new FunctionTask<Function>(&group, Function(std::forward<F>(function))));
+}
+
+template<class F>
+void ThreadPool::parallelFor(size_t first, size_t last, F &&body, size_t grain) {
+    if (first >= last) {
+        return;
+    }
+    if (grain == 0) {
+        // a few chunks per worker leave room for stealing when the chunks are uneven
+        size_t chunks = 4 * (size() + 1);
+        grain = (last - first + chunks - 1) / chunks;
+    }
+
+    TaskGroup group;
+    for (size_t from = first; from < last; from += grain) {
+        size_t to = last - from > grain ? from + grain : last;
+        submit(group, [&body, from, to]() {
+            for (size_t i = from; i < to; ++i) {
+                body(i);
+            }
+        });
+    }
+    wait(group);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+
+namespace kstd {
+    /*
+     * a type is trivially relocatable when moving an object to a new address
+     * and ending the lifetime of the old one is equivalent to copying its bytes
+     *
+     * containers use it to grow, shift and erase with memcpy / memmove / realloc
+     * instead of moving the elements one by one
+     *
+     * every trivially copyable type qualifies, other types opt in
+     * by specialising the trait next to their definition
+     */
+    template<class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<class T>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    /*
+     * an iterator is contiguous when the elements it walks over lie next to each other,
+     * so a run of them can be copied with one memcpy starting at &*it
+     *
+     * pointers qualify, iterator types opt in like for is_trivially_relocatable
+     */
+    template<class It>
+    struct is_contiguous_iterator : std::is_pointer<It> {};
+
+    template<class It>
+    constexpr bool is_contiguous_iterator_v = is_contiguous_iterator<It>::value;
+
+    /*
+     * a forward iterator can walk a range more than once,
+     * so the length of the range can be measured before it is copied
+     *
+     * input iterators such as std::istream_iterator cannot and are read in a single pass
+     */
+    template<class It>
+    constexpr bool is_forward_iterator_v = std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<It>::iterator_category>;
+}
@@ -1,16 +1,24 @@
 #pragma once
 
 #include <utility>
+#include <new>
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
+// without a resource the object is owned through new / delete,
+// with one it is destroyed and given back to that resource
 template<class T>
 class UniquePtr {
 private:
     T *ptr;
+    MemoryResource *resource_;
 public:
     UniquePtr();
 
     explicit UniquePtr(T *ptr);
 
+    UniquePtr(T *ptr, MemoryResource *resource);
+
     UniquePtr(const UniquePtr<T> &other) = delete;
 
     UniquePtr &operator=(const UniquePtr<T> &other) = delete;
@@ -25,8 +33,12 @@ public:
 
     void reset(T *p = nullptr);
 
+    void reset(T *p, MemoryResource *resource);
+
     T *get() const noexcept;
 
+    MemoryResource *resource() const noexcept;
+
     explicit operator bool() const noexcept;
 
     const T &operator*() const;
@@ -43,6 +55,11 @@ private:
     void moveFrom(UniquePtr<T> &&other);
 };
 
+namespace kstd {
+    template<class T>
+    struct is_trivially_relocatable<UniquePtr<T>> : std::true_type {};
+}
+
 template<class T>
 UniquePtr<T> makeUnique(const T &value) {
     T *ptr = new T(value);
@@ -50,10 +67,20 @@ UniquePtr<T> makeUnique(const T &value) {
 }
 
 template<class T>
-UniquePtr<T>::UniquePtr() : ptr{nullptr} {}
+UniquePtr<T> makeUnique(MemoryResource *resource, const T &value) {
+    void *memory = resource->allocate(sizeof(T), alignof(T));
+    T *ptr = new(memory) T(value);
+    return UniquePtr<T>(ptr, resource);
+}
+
+template<class T>
+UniquePtr<T>::UniquePtr() : ptr{nullptr}, resource_{nullptr} {}
 
 template<class T>
-UniquePtr<T>::UniquePtr(T *ptr) : ptr{ptr} {}
+UniquePtr<T>::UniquePtr(T *ptr) : ptr{ptr}, resource_{nullptr} {}
+
+template<class T>
+UniquePtr<T>::UniquePtr(T *ptr, MemoryResource *resource) : ptr{ptr}, resource_{resource} {}
 
 template<class T>
 UniquePtr<T>::UniquePtr(UniquePtr<T> &&other) noexcept {
@@ -83,9 +110,16 @@ T *UniquePtr<T>::release() noexcept {
 
 template<class T>
 void UniquePtr<T>::reset(T *p) {
+    reset(p, nullptr);
+}
+
+template<class T>
+void UniquePtr<T>::reset(T *p, MemoryResource *resource) {
+    // resetting to the owned pointer keeps it and the resource it came from
     if (ptr != p) {
         free();
         ptr = p;
+        resource_ = resource;
     }
 }
 
@@ -94,6 +128,11 @@ T *UniquePtr<T>::get() const noexcept {
     return ptr;
 }
 
+template<class T>
+MemoryResource *UniquePtr<T>::resource() const noexcept {
+    return resource_;
+}
+
 template<class T>
 UniquePtr<T>::operator bool() const noexcept {
     return ptr != nullptr;
@@ -121,12 +160,18 @@ T *UniquePtr<T>::operator->() noexcept {
 
 template<class T>
 void UniquePtr<T>::free() {
-    delete ptr;
+    if (ptr && resource_) {
+        ptr->~T();
+        resource_->deallocate(ptr, sizeof(T), alignof(T));
+    } else {
+        delete ptr;
+    }
     ptr = nullptr;
 }
 
 template<class T>
 void UniquePtr<T>::moveFrom(UniquePtr<T> &&other) {
     ptr = other.ptr;
+    resource_ = other.resource_;
     other.ptr = nullptr;
 }
\ No newline at end of file
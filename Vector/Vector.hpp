@@ -1,12 +1,19 @@
 #pragma once
 
 #include <cstddef>
+#include <iterator>
 #include <utility>
 #include <stdexcept>
+#include <new>
+#include <type_traits>
 #include "../ArrayIterator/ArrayIterator.hpp"
 #include "../Algorithm/Algorithm.hpp"
+#include "../Memory/Memory.hpp"
+#include "../TypeTraits/TypeTraits.hpp"
+#include "../GrowthPolicy/GrowthPolicy.hpp"
+#include "../MemoryResource/MemoryResource.h"
 
-template<class T>
+template<class T, class Policy = GrowthPolicy<>>
 class Vector {
 public:
     typedef T value_type;
@@ -18,28 +25,34 @@ public:
     typedef const T *const_pointer;
     typedef ArrayIterator<value_type> iterator;
     typedef ArrayIterator<const value_type> const_iterator;
+    typedef Policy growth_policy;
 
 private:
     pointer data_;
     size_type size_;
     size_type capacity_;
+    MemoryResource *resource_;
 
     static const short INITIAL_CAPACITY = 2;
 public:
     // MARK: big 6 -d
     Vector();
 
-    Vector(std::initializer_list<value_type> data);
+    explicit Vector(MemoryResource *resource);
 
-    explicit Vector(size_type capacity);
+    Vector(std::initializer_list<value_type> data, MemoryResource *resource = defaultResource());
 
-    Vector(const Vector<T> &other);
+    explicit Vector(size_type capacity, MemoryResource *resource = defaultResource());
 
-    Vector(Vector<T> &&other) noexcept;
+    Vector(const Vector<T, Policy> &other);
 
-    Vector<T> &operator=(const Vector<T> &other);
+    Vector(const Vector<T, Policy> &other, MemoryResource *resource);
 
-    Vector<T> &operator=(Vector<T> &&other) noexcept;
+    Vector(Vector<T, Policy> &&other) noexcept;
+
+    Vector<T, Policy> &operator=(const Vector<T, Policy> &other);
+
+    Vector<T, Policy> &operator=(Vector<T, Policy> &&other) noexcept;
 
     ~Vector();
 
@@ -50,6 +63,8 @@ public:
 
     void assign(std::initializer_list<value_type> data);
 
+    MemoryResource *resource() const noexcept;
+
     // MARK: element access -d
     const_reference at(size_type idx) const;
 
@@ -91,73 +106,115 @@ public:
 
     size_type capacity() const noexcept;
 
+    void reserve(size_type capacity);
+
+    void shrinkToFit();
+
     // MARK: modifiers -d
     void clear() noexcept;
 
-//    iterator insert(const_iterator pos, const T &value);
-//
-//    iterator insert(const_iterator pos, T &&value);
-//
-//    iterator insert(const_iterator pos, size_t count, const T &value);
-//
-//    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+    iterator insert(const_iterator pos, const T &value);
+
+    iterator insert(const_iterator pos, T &&value);
+
+    iterator insert(const_iterator pos, size_t count, const T &value);
+
+    template<class InputIt, class = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
 
     iterator erase(const_iterator pos);
 
-//    iterator erase(const_iterator first, const_iterator last);
+    iterator erase(const_iterator first, const_iterator last);
+
+    template<class UnaryPredicate>
+    size_type eraseIf(UnaryPredicate p);
 
     void pushBack(const T &value);
 
     void pushBack(T &&value);
 
+    template<class... Args>
+    reference emplaceBack(Args &&... args);
+
     void popBack();
 
     void resize(size_t capacity);
 
-    void swap(const Vector<T> &other);
+    void swap(Vector<T, Policy> &other);
 
 private:
     // MARK: big 6 helpers -d
     void free();
 
-    void copyFrom(const Vector<T> &other);
+    void copyFrom(const Vector<T, Policy> &other);
+
+    void moveFrom(Vector<T, Policy> &&other);
 
-    void moveFrom(Vector<T> &&other);
+    // MARK: storage helpers -d
+    // the buffer is raw memory, only [0, size_) holds constructed elements
+    void destroy(size_type from, size_type to) noexcept;
+
+    void reallocate(size_type capacity);
+
+    void grow();
+
+    size_type grownCapacity(size_type required) const;
+
+    void relocateWithin(size_type first, size_type last, size_type dest);
+
+    void openGap(size_type idx, size_type count);
+
+    iterator insertAt(size_type idx, T &&value);
 };
 
+namespace kstd {
+    template<class T, class Policy>
+    struct is_trivially_relocatable<Vector<T, Policy>> : std::true_type {};
+}
+
 // MARK: big 6 -i
-template<class T>
-Vector<T>::Vector() : Vector<T>(0) {}
+template<class T, class Policy>
+Vector<T, Policy>::Vector() : Vector<T, Policy>(defaultResource()) {}
+
+template<class T, class Policy>
+Vector<T, Policy>::Vector(MemoryResource *resource)
+        : data_{nullptr}, size_{0}, capacity_{0}, resource_{resource} {}
 
-template<class T>
-Vector<T>::Vector(std::initializer_list<T> data) {
-    size_ = data.size();
+template<class T, class Policy>
+Vector<T, Policy>::Vector(std::initializer_list<T> data, MemoryResource *resource) : resource_{resource} {
+    size_ = 0;
     capacity_ = data.size() * 2;
-    data_ = new T[capacity_];
+    data_ = kstd::allocate<T>(resource_, capacity_);
 
-    size_t idx = 0;
     for (auto el = data.begin(); el != data.end(); ++el) {
-        data_[idx++] = *el;
+        new(&data_[size_]) T(*el);
+        size_++;
     }
 }
 
-template<class T>
-Vector<T>::Vector(size_t capacity) : size_{0}, capacity_{capacity} {
-    data_ = new T[capacity_];
+template<class T, class Policy>
+Vector<T, Policy>::Vector(size_t capacity, MemoryResource *resource)
+        : size_{0}, capacity_{capacity}, resource_{resource} {
+    data_ = kstd::allocate<T>(resource_, capacity_);
 }
 
-template<class T>
-Vector<T>::Vector(const Vector<T> &other) {
+template<class T, class Policy>
+Vector<T, Policy>::Vector(const Vector<T, Policy> &other) : Vector<T, Policy>(other, defaultResource()) {}
+
+template<class T, class Policy>
+Vector<T, Policy>::Vector(const Vector<T, Policy> &other, MemoryResource *resource) : resource_{resource} {
     copyFrom(other);
 }
 
-template<class T>
-Vector<T>::Vector(Vector<T> &&other) noexcept {
+template<class T, class Policy>
+Vector<T, Policy>::Vector(Vector<T, Policy> &&other) noexcept : resource_{other.resource_} {
     moveFrom(std::move(other));
 }
 
-template<class T>
-Vector<T> &Vector<T>::operator=(const Vector<T> &other) {
+template<class T, class Policy>
+Vector<T, Policy> &Vector<T, Policy>::operator=(const Vector<T, Policy> &other) {
     if (this != &other) {
         free();
         copyFrom(other);
@@ -166,273 +223,454 @@ Vector<T> &Vector<T>::operator=(const Vector<T> &other) {
 
 }
 
-template<class T>
-Vector<T> &Vector<T>::operator=(Vector<T> &&other) noexcept {
+template<class T, class Policy>
+Vector<T, Policy> &Vector<T, Policy>::operator=(Vector<T, Policy> &&other) noexcept {
     if (this != &other) {
         free();
+        resource_ = other.resource_;
         moveFrom(std::move(other));
     }
     return *this;
 }
 
-template<class T>
-Vector<T>::~Vector() {
+template<class T, class Policy>
+Vector<T, Policy>::~Vector() {
     free();
 }
 
-template<class T>
-void Vector<T>::assign(Vector::size_type count, const T &value) {
-    free();
-    size_ = capacity_ = count;
-    data_ = new T[capacity_];
+template<class T, class Policy>
+void Vector<T, Policy>::assign(Vector::size_type count, const T &value) {
+    // value may refer to an element, so it is copied before the elements are cleared
+    T temp(value);
+    clear();
+    if (count > capacity_) {
+        reallocate(count);
+    }
 
-    for (size_type i = 0; i < count; ++i) {
-        data_[i] = value;
+    for (; size_ < count; ++size_) {
+        new(&data_[size_]) T(temp);
     }
 }
 
-template<class T>
+template<class T, class Policy>
 template<class InputIt>
-void Vector<T>::assign(InputIt first, InputIt last) {
-    free();
-    size_ = capacity_ = last - first;
-    data_ = new T[capacity_];
-
-    size_type i = 0;
-    for (auto it = first; it != last; ++it) {
-        data_[i++] = *it;
+void Vector<T, Policy>::assign(InputIt first, InputIt last) {
+    clear();
+    if constexpr (!kstd::is_forward_iterator_v<InputIt>) {
+        for (; first != last; ++first) {
+            emplaceBack(*first);
+        }
+    } else {
+        size_type count = std::distance(first, last);
+        if (count > capacity_) {
+            reallocate(count);
+        }
+
+        for (auto it = first; it != last; ++it) {
+            new(&data_[size_]) T(*it);
+            size_++;
+        }
     }
 }
 
-template<class T>
-void Vector<T>::assign(std::initializer_list<value_type> data) {
+template<class T, class Policy>
+void Vector<T, Policy>::assign(std::initializer_list<value_type> data) {
     assign(data.begin(), data.end());
 }
 
+template<class T, class Policy>
+MemoryResource *Vector<T, Policy>::resource() const noexcept {
+    return resource_;
+}
+
 // MARK: element access -i
-template<class T>
-typename Vector<T>::const_reference Vector<T>::at(size_t idx) const {
-    if (idx > size_) {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_reference Vector<T, Policy>::at(size_t idx) const {
+    if (idx >= size_) {
         throw std::out_of_range("index is out of range!");
     }
     return data_[idx];
 }
 
-template<class T>
-typename Vector<T>::reference Vector<T>::at(size_t idx) {
-    if (idx > size_) {
+template<class T, class Policy>
+typename Vector<T, Policy>::reference Vector<T, Policy>::at(size_t idx) {
+    if (idx >= size_) {
         throw std::out_of_range("index is out of range!");
     }
     return data_[idx];
 }
 
-template<class T>
-typename Vector<T>::const_reference Vector<T>::operator[](size_t idx) const {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_reference Vector<T, Policy>::operator[](size_t idx) const {
     return data_[idx];
 }
 
-template<class T>
-typename Vector<T>::reference Vector<T>::operator[](size_t idx) {
+template<class T, class Policy>
+typename Vector<T, Policy>::reference Vector<T, Policy>::operator[](size_t idx) {
     return data_[idx];
 }
 
-template<class T>
-typename Vector<T>::const_reference Vector<T>::front() const {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_reference Vector<T, Policy>::front() const {
     if (empty()) {
         throw std::length_error("vector is empty!");
     }
     return data_[0];
 }
 
-template<class T>
-typename Vector<T>::reference Vector<T>::front() {
+template<class T, class Policy>
+typename Vector<T, Policy>::reference Vector<T, Policy>::front() {
     if (empty()) {
         throw std::length_error("vector is empty!");
     }
     return data_[0];
 }
 
-template<class T>
-typename Vector<T>::const_reference Vector<T>::back() const {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_reference Vector<T, Policy>::back() const {
     if (empty()) {
         throw std::length_error("vector is empty!");
     }
     return data_[size_ - 1];
 }
 
-template<class T>
-typename Vector<T>::reference Vector<T>::back() {
+template<class T, class Policy>
+typename Vector<T, Policy>::reference Vector<T, Policy>::back() {
     if (empty()) {
         throw std::length_error("vector is empty!");
     }
     return data_[size_ - 1];
 }
 
-template<class T>
-typename Vector<T>::const_pointer Vector<T>::data() const noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_pointer Vector<T, Policy>::data() const noexcept {
     return data_;
 }
 
-template<class T>
-typename Vector<T>::pointer Vector<T>::data() noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::pointer Vector<T, Policy>::data() noexcept {
     return data_;
 }
 
 // MARK: iterators -i
-template<class T>
-typename Vector<T>::const_iterator Vector<T>::begin() const noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_iterator Vector<T, Policy>::begin() const noexcept {
     return const_iterator(data_);
 }
 
-template<class T>
-typename Vector<T>::iterator Vector<T>::begin() noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::begin() noexcept {
     return iterator(data_);
 }
 
-template<class T>
-typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::const_iterator Vector<T, Policy>::cbegin() const noexcept {
     return const_iterator(data_);
 }
 
-template<class T>
-typename Vector<T>::const_iterator Vector<T>::end() const noexcept {
-    return const_iterator(&data_[size_]);
+template<class T, class Policy>
+typename Vector<T, Policy>::const_iterator Vector<T, Policy>::end() const noexcept {
+    return const_iterator(data_ + size_);
 }
 
-template<class T>
-typename Vector<T>::iterator Vector<T>::end() noexcept {
-    return iterator(&data_[size_]);
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::end() noexcept {
+    return iterator(data_ + size_);
 }
 
-template<class T>
-typename Vector<T>::const_iterator Vector<T>::cend() const noexcept {
-    return const_iterator(&data_[size_]);
+template<class T, class Policy>
+typename Vector<T, Policy>::const_iterator Vector<T, Policy>::cend() const noexcept {
+    return const_iterator(data_ + size_);
 }
 
 // MARK: capacity -i
-template<class T>
-bool Vector<T>::empty() const noexcept {
+template<class T, class Policy>
+bool Vector<T, Policy>::empty() const noexcept {
     return size_ == 0;
 }
 
-template<class T>
-typename Vector<T>::size_type Vector<T>::size() const noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::size_type Vector<T, Policy>::size() const noexcept {
     return size_;
 }
 
-template<class T>
-typename Vector<T>::size_type Vector<T>::capacity() const noexcept {
+template<class T, class Policy>
+typename Vector<T, Policy>::size_type Vector<T, Policy>::capacity() const noexcept {
     return capacity_;
 }
 
-// MARK: modifiers -i
-template<class T>
-void Vector<T>::clear() noexcept {
-    for (size_type i = 0; i < size_; ++i) {
-        data_[i] = T();
+template<class T, class Policy>
+void Vector<T, Policy>::reserve(size_type capacity) {
+    if (capacity > capacity_) {
+        reallocate(capacity);
+    }
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::shrinkToFit() {
+    if (capacity_ > size_) {
+        reallocate(size_);
     }
-    size_ = 0;
 }
 
+// MARK: modifiers -i
+template<class T, class Policy>
+void Vector<T, Policy>::clear() noexcept {
+    destroy(0, size_);
+    size_ = 0;
+}
 
-template<class T>
-typename Vector<T>::iterator Vector<T>::erase(Vector::const_iterator pos) {
-    difference_type dist = pos - cbegin();
-    iterator el = begin() + dist;
 
-    if (el == end() - 1) {
-        *el = T();
-        size_--;
-        return end();
-    }
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insert(Vector::const_iterator pos, const T &value) {
+    return insertAt(pos - cbegin(), T(value));
+}
 
-    iterator last = end() - 1;
-    for (auto it = el; it != last; ++it) {
-        *it = std::move(*(it + 1));
-    }
-    size_--;
-    return end();
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insert(Vector::const_iterator pos, T &&value) {
+    return insertAt(pos - cbegin(), std::move(value));
 }
 
-template<class T>
-void Vector<T>::pushBack(const T &value) {
-    if (capacity_ == 0) {
-        resize(INITIAL_CAPACITY);
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insert(Vector::const_iterator pos, size_t count, const T &value) {
+    size_type idx = pos - cbegin();
+    // value may refer to an element, so it is copied before the gap is opened
+    T temp(value);
+    openGap(idx, count);
+
+    for (size_type i = idx; i < idx + count; ++i) {
+        new(&data_[i]) T(temp);
     }
-    if (size_ == capacity_) {
-        resize(2 * capacity_);
+    size_ += count;
+    return begin() + idx;
+}
+
+template<class T, class Policy>
+template<class InputIt, class>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insert(Vector::const_iterator pos, InputIt first, InputIt last) {
+    size_type idx = pos - cbegin();
+    if constexpr (!kstd::is_forward_iterator_v<InputIt>) {
+        // a single pass range cannot be measured, so it is read into a buffer first
+        Vector<T, Policy> buffer(resource_);
+        for (; first != last; ++first) {
+            buffer.emplaceBack(*first);
+        }
+        return insert(cbegin() + idx, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+    } else {
+        size_type count = std::distance(first, last);
+        openGap(idx, count);
+
+        size_type i = idx;
+        for (auto it = first; it != last; ++it) {
+            new(&data_[i++]) T(*it);
+        }
+        size_ += count;
+        return begin() + idx;
     }
+}
 
-    data_[size_++] = value;
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insert(Vector::const_iterator pos, std::initializer_list<T> ilist) {
+    return insert(pos, ilist.begin(), ilist.end());
 }
 
-template<class T>
-void Vector<T>::pushBack(T &&value) {
-    if (capacity_ == 0) {
-        resize(INITIAL_CAPACITY);
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::erase(Vector::const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::erase(Vector::const_iterator first, Vector::const_iterator last) {
+    size_type from = first - cbegin();
+    size_type to = last - cbegin();
+
+    destroy(from, to);
+    relocateWithin(to, size_, from);
+    size_ -= to - from;
+    return begin() + from;
+}
+
+template<class T, class Policy>
+template<class UnaryPredicate>
+typename Vector<T, Policy>::size_type Vector<T, Policy>::eraseIf(UnaryPredicate p) {
+    // one pass that asks p once per element, removed elements are destroyed
+    // in place and every run of kept elements is moved down to the compacted prefix at once
+    size_type kept = 0;
+    size_type run = 0;
+    for (size_type i = 0; i < size_; ++i) {
+        if (p(data_[i])) {
+            relocateWithin(run, i, kept);
+            kept += i - run;
+            destroy(i, i + 1);
+            run = i + 1;
+        }
     }
+    relocateWithin(run, size_, kept);
+    kept += size_ - run;
+
+    size_type removed = size_ - kept;
+    size_ = kept;
+    return removed;
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::pushBack(const T &value) {
+    emplaceBack(value);
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::pushBack(T &&value) {
+    emplaceBack(std::move(value));
+}
+
+template<class T, class Policy>
+template<class... Args>
+typename Vector<T, Policy>::reference Vector<T, Policy>::emplaceBack(Args &&... args) {
     if (size_ == capacity_) {
-        resize(2 * capacity_);
+        // args may refer to an element, so it is built before the reallocation
+        T temp(std::forward<Args>(args)...);
+        grow();
+        new(&data_[size_]) T(std::move(temp));
+    } else {
+        new(&data_[size_]) T(std::forward<Args>(args)...);
     }
-
-    data_[size_++] = std::move(value);
+    return data_[size_++];
 }
 
-template<class T>
-void Vector<T>::popBack() {
+template<class T, class Policy>
+void Vector<T, Policy>::popBack() {
     if (empty()) {
         throw std::length_error("vector is empty!");
     }
+    destroy(size_ - 1, size_);
     size_--;
 
-    if (capacity_ > 4 * size_) {
-        resize(capacity_ / 2);
+    size_type capacity = Policy::shrink(capacity_, size_);
+    if (capacity < capacity_) {
+        reallocate(capacity);
     }
 }
 
-template<class T>
-void Vector<T>::resize(size_t capacity) {
-    capacity_ = capacity;
-    T *newData = new T[capacity_];
-
-    for (size_t i = 0; i < size_; ++i) {
-        newData[i] = data_[i];
-    }
-
-    free();
-    data_ = newData;
+template<class T, class Policy>
+void Vector<T, Policy>::resize(size_t capacity) {
+    reallocate(capacity);
 }
 
 // MARK: big 6 helpers -i
-template<class T>
-void Vector<T>::free() {
-    delete[] data_;
+template<class T, class Policy>
+void Vector<T, Policy>::free() {
+    destroy(0, size_);
+    kstd::deallocate(resource_, data_, capacity_);
     data_ = nullptr;
+    size_ = capacity_ = 0;
 }
 
-template<class T>
-void Vector<T>::copyFrom(const Vector<T> &other) {
-    size_ = other.size_;
+template<class T, class Policy>
+void Vector<T, Policy>::copyFrom(const Vector<T, Policy> &other) {
+    size_ = 0;
     capacity_ = other.capacity_;
-    data_ = new T[capacity_];
+    data_ = kstd::allocate<T>(resource_, capacity_);
 
-    for (size_t i = 0; i < size_; ++i) {
-        data_[i] = other.data_[i];
+    for (; size_ < other.size_; ++size_) {
+        new(&data_[size_]) T(other.data_[size_]);
     }
 }
 
-template<class T>
-void Vector<T>::moveFrom(Vector<T> &&other) {
+template<class T, class Policy>
+void Vector<T, Policy>::moveFrom(Vector<T, Policy> &&other) {
     size_ = other.size_;
     capacity_ = other.capacity_;
 
     data_ = other.data_;
     other.data_ = nullptr;
+    other.size_ = other.capacity_ = 0;
 }
 
-template<class T>
-void Vector<T>::swap(const Vector<T> &other) {
+template<class T, class Policy>
+void Vector<T, Policy>::swap(Vector<T, Policy> &other) {
     kstd::swap(capacity_, other.capacity_);
     kstd::swap(size_, other.size_);
     kstd::swap(data_, other.data_);
+    kstd::swap(resource_, other.resource_);
+}
+
+// MARK: storage helpers -i
+template<class T, class Policy>
+void Vector<T, Policy>::destroy(size_type from, size_type to) noexcept {
+    kstd::destroy(data_ + from, data_ + to);
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::reallocate(size_type capacity) {
+    if (capacity < size_) {
+        destroy(capacity, size_);
+        size_ = capacity;
+    }
+
+    data_ = kstd::reallocate(resource_, data_, size_, capacity_, capacity);
+    capacity_ = capacity;
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::grow() {
+    reallocate(grownCapacity(size_ + 1));
+}
+
+template<class T, class Policy>
+typename Vector<T, Policy>::size_type Vector<T, Policy>::grownCapacity(size_type required) const {
+    if (required < INITIAL_CAPACITY) {
+        required = INITIAL_CAPACITY;
+    }
+    return Policy::grow(capacity_, required, sizeof(T));
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::relocateWithin(size_type first, size_type last, size_type dest) {
+    if (first == dest) {
+        return;
+    }
+
+    if constexpr (kstd::is_trivially_relocatable_v<T>) {
+        kstd::relocateOverlapping(data_ + first, data_ + last, data_ + dest);
+    } else if (dest < first) {
+        for (size_type i = first; i < last; ++i) {
+            new(&data_[dest + (i - first)]) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+    } else {
+        for (size_type i = last; i > first; --i) {
+            new(&data_[dest + (i - 1 - first)]) T(std::move(data_[i - 1]));
+            data_[i - 1].~T();
+        }
+    }
+}
+
+template<class T, class Policy>
+void Vector<T, Policy>::openGap(size_type idx, size_type count) {
+    // leaves [idx, idx + count) as raw memory, size_ is not changed
+    if (size_ + count <= capacity_) {
+        relocateWithin(idx, size_, idx + count);
+        return;
+    }
+
+    size_type capacity = grownCapacity(size_ + count);
+
+    pointer newData = kstd::allocate<T>(resource_, capacity);
+    kstd::relocate(data_, data_ + idx, newData);
+    kstd::relocate(data_ + idx, data_ + size_, newData + idx + count);
+
+    kstd::deallocate(resource_, data_, capacity_);
+    data_ = newData;
+    capacity_ = capacity;
+}
+
+template<class T, class Policy>
+typename Vector<T, Policy>::iterator Vector<T, Policy>::insertAt(size_type idx, T &&value) {
+    // value may refer to an element, so it is taken out before the gap is opened
+    T temp(std::move(value));
+    openGap(idx, 1);
+
+    new(&data_[idx]) T(std::move(temp));
+    size_++;
+    return begin() + idx;
 }
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "../Memory/Memory.hpp"
+#include "../MemoryResource/MemoryResource.h"
+#include "../Vector/Vector.hpp"
+
+/*
+ * Chase-Lev work-stealing deque
+ * (with the memory orders of Le, Pop, Cohen, Zappa Nardelli - 2013)
+ *
+ * the owner thread pushes and pops at the bottom like a stack,
+ * any other thread may steal from the top, only the last element is contended
+ *
+ * the ring grows when the owner finds it full, old rings are kept
+ * until the deque is destroyed because a thief may still be reading one
+ *
+ * elements are read and written as atomics, so T has to be trivially copyable,
+ * usually it is a pointer to a task
+ */
+template<class T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "the elements are copied by racing threads");
+private:
+    struct Ring {
+        size_t mask;
+        std::atomic<T> *elements;
+
+        std::atomic<T> &operator[](int64_t idx) const noexcept {
+            return elements[size_t(idx) & mask];
+        }
+    };
+
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<int64_t> top;
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<int64_t> bottom;
+    alignas(kstd::CACHE_LINE_SIZE) std::atomic<Ring *> ring;
+    Vector<Ring *> retired;
+    MemoryResource *resource_;
+
+    static const size_t INITIAL_CAPACITY = 64;
+
+public:
+    explicit WorkStealingDeque(size_t capacity = INITIAL_CAPACITY, MemoryResource *resource = defaultResource());
+
+    WorkStealingDeque(const WorkStealingDeque<T> &other) = delete;
+
+    WorkStealingDeque<T> &operator=(const WorkStealingDeque<T> &other) = delete;
+
+    ~WorkStealingDeque();
+
+    // MARK: owner -d
+    void push(T element);
+
+    // takes the most recently pushed element
+    bool pop(T &element);
+
+    // MARK: thieves -d
+    // takes the oldest element, fails when the deque is empty or another thread won the race
+    bool steal(T &element);
+
+    // MARK: capacity -d
+    // exact only for the owner when no thief is running
+    bool empty() const noexcept;
+
+    size_t size() const noexcept;
+
+    size_t capacity() const noexcept;
+
+    MemoryResource *resource() const noexcept;
+
+private:
+    Ring *makeRing(size_t capacity);
+
+    void freeRing(Ring *r) noexcept;
+
+    Ring *grow(Ring *r, int64_t from, int64_t to);
+};
+
+template<class T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity, MemoryResource *resource)
+        : top{0}, bottom{0}, ring{nullptr}, retired(resource), resource_{resource} {
+    ring.store(makeRing(kstd::ceilPowerOfTwo(capacity == 0 ? 1 : capacity)), std::memory_order_relaxed);
+}
+
+template<class T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    freeRing(ring.load(std::memory_order_relaxed));
+    for (Ring *r: retired) {
+        freeRing(r);
+    }
+}
+
+// MARK: owner -i
+template<class T>
+void WorkStealingDeque<T>::push(T element) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Ring *r = ring.load(std::memory_order_relaxed);
+
+    if (size_t(b - t) > r->mask) {
+        r = grow(r, t, b);
+    }
+
+    (*r)[b].store(element, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template<class T>
+bool WorkStealingDeque<T>::pop(T &element) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Ring *r = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    element = (*r)[b].load(std::memory_order_relaxed);
+    if (t == b) {
+        // the last element, race the thieves for it
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+// MARK: thieves -i
+template<class T>
+bool WorkStealingDeque<T>::steal(T &element) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return false;
+    }
+
+    Ring *r = ring.load(std::memory_order_acquire);
+    T stolen = (*r)[t].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+    element = stolen;
+    return true;
+}
+
+// MARK: capacity -i
+template<class T>
+bool WorkStealingDeque<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<class T>
+size_t WorkStealingDeque<T>::size() const noexcept {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? size_t(b - t) : 0;
+}
+
+template<class T>
+size_t WorkStealingDeque<T>::capacity() const noexcept {
+    return ring.load(std::memory_order_relaxed)->mask + 1;
+}
+
+template<class T>
+MemoryResource *WorkStealingDeque<T>::resource() const noexcept {
+    return resource_;
+}
+
+// MARK: helpers -i
+template<class T>
+typename WorkStealingDeque<T>::Ring *WorkStealingDeque<T>::makeRing(size_t capacity) {
+    Ring *r = kstd::allocate<Ring>(resource_, 1);
+    r->mask = capacity - 1;
+    r->elements = kstd::allocate<std::atomic<T>>(resource_, capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        new(r->elements + i) std::atomic<T>();
+    }
+    return r;
+}
+
+template<class T>
+void WorkStealingDeque<T>::freeRing(Ring *r) noexcept {
+    kstd::deallocate(resource_, r->elements, r->mask + 1);
+    kstd::deallocate(resource_, r, 1);
+}
+
+template<class T>
+typename WorkStealingDeque<T>::Ring *WorkStealingDeque<T>::grow(Ring *r, int64_t from, int64_t to) {
+    Ring *bigger = makeRing(2 * (r->mask + 1));
+    for (int64_t idx = from; idx != to; ++idx) {
+        (*bigger)[idx].store((*r)[idx].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    retired.pushBack(r);
+    ring.store(bigger, std::memory_order_release);
+    return bigger;
+}